@@ -26,6 +26,8 @@ import {
 	buildRowsMaxRow,
 	bitsWordMgr,
 	binaryWriter,
+	buildPerfectHash,
+	eytzingerLayout,
 	
 	codeFrame,
 	hashSHA256, readFilesDeepInDirFlat,
@@ -2852,6 +2854,346 @@ class Builder {
 	}
 }
 
+/// ######################
+/// Reflect tables. Pure functions of the flat type/func lists, so the tables can be emitted without a pdb (Tests/Fixture.js)
+const createCodeArray = arrName => itemType => list => list
+	.reduce((s, c) => s.addCell(c), buildRowsMaxRow(150))
+	.getRows()
+	.$next(buildLines)
+	.$next(fTextPadStart(GAP))
+	.$next(l => buildLines( `${itemType} ${arrName}[${list.length}] = {`, l, `};`, ) )
+
+const codePerfectHash = (arrName, ph) => buildLines(
+	`constexpr int32_t ${arrName}SeedCount = ${ ph.seedCount };`,
+	`constexpr int32_t ${arrName}SlotCount = ${ ph.slotCount };`,
+	ph
+		.seedList
+		.map(s => `${ s }, `)
+		.$next( createCodeArray(`${arrName}SeedList`)('constexpr uint32_t') ),
+	ph
+		.slotList
+		.$next(l => l.length ? l : [0])
+		.map(v => `${ v }, `)
+		.$next( createCodeArray(`${arrName}SlotList`)('constexpr int32_t') ),
+)
+
+const codeWriteBitsFlags = fCrtArr => bits => bits
+	.reduce((s, f, i) => s.setBit(i, f), bitsWordMgr(64))
+	.getWords()
+	.map(w => uintToHex(w, {padStart: 16}) + ', ')
+	.$next(fCrtArr('const uint64_t'))
+
+const EnumTypeMap = {
+	TypeVoid    : 1, 
+	TypeScalar  : 2,
+	TypeBitfield: 3,			
+
+	TypePointer : 4,
+	TypeArray   : 5,
+	TypeStruct  : 6,
+	TypeClass   : 7,
+	TypeUnion   : 8,
+	
+	TypeDataMemberField: 10,
+	TypeStaticDataMemberField: 11,
+	
+	TypeVar: 12,
+}
+/// Must match EnumScalarKind (GetStructInfo.cpp)
+const EnumScalarKindMap = {
+	int8_t   : 1,
+	int16_t  : 2,
+	int32_t  : 3,
+	int64_t  : 4,
+
+	uint8_t  : 5,
+	uint16_t : 6,
+	uint32_t : 7,
+	uint64_t : 8,
+
+	float32_t: 9,
+	float64_t: 10,
+
+	bool     : 11,
+	char     : 12,
+	uchar16_t: 13,
+	HRESULT  : 14,
+}
+
+/// sectionMap: [null | { rva, size, align, characteristics, name }], index is the section id of the addresses
+/// Returns the code of Reflect/AG_Module.hpp
+export function codeReflectModule(sectionMap, baseAddress) {
+	const acReflectModule = codeFrame()
+		.createFileFrame()
+		.createNamespaceFrame('Reflect')
+	
+	const i32u32 = n => (n = n|0, n < 0 ? (2**32) + n : n)
+
+	acReflectModule(`
+struct TSection {
+	bool         valid           = false;
+	uint64_t     rva             = 0;
+	uint64_t     size            = 0;
+	uint64_t     align           = 0;
+	uint64_t     characteristics = 0;
+	const char * name            = "";
+};`
+		.trim()
+	)
+	
+	acReflectModule(`constexpr uint64_t ATFSignature = {ATF_SIGNATURE_U64};`)
+	acReflectModule(`constexpr uint64_t BaseAddressExpected = ${ uintToHex(baseAddress) };`)
+	sectionMap
+		.map(s => (!s ? `TSection{},` : 
+			`TSection{ true, ${ uintToHex(s.rva) }, ${ uintToHex(s.size) }, ${ uintToHex(s.align) }, ${ uintToHex(i32u32(s.characteristics)) }, "${ s.name }" },`) )
+		.$next( buildLines )
+		.$next( fTextPadStart(GAP) )
+		.$next( s => buildLines( `constexpr std::array< TSection, ${ sectionMap.length } > Sections = {`, s, `};` ) )
+		.$next( acReflectModule )
+	
+	acReflectModule(`
+#ifdef _WIN32
+	const uint64_t BaseAddress = (uint64_t)GetModuleHandleA(nullptr);
+#else
+	const uint64_t BaseAddress = BaseAddressExpected;		/// Non-Windows builds only read other processes, the image is not loaded here
+#endif`
+		.trim()
+	)
+
+	return acReflectModule.buildRoot()
+}
+/// typeList: [null, { id, name, type, size, elementTypeID, offset, fieldIdRng, startingPosition, bits, address }, ...]
+/// Returns the code of Reflect/AG_StructInfoList.cpp and Reflect/AG_StructInfo.cpp
+export function codeReflectStructInfo(typeList) {
+	const acReflectStructList = codeFrame()
+		.createFileFrame()
+		.createNamespaceFrame('__Local__')
+		.createPackedFrame()
+
+	const createUnqList = () => {
+		const map = new Map()
+		const list = [null]
+		const add = val => {
+			if ( map.has(val) )
+				return map.get(val)
+			
+			const id = list.length
+			map.set(val, id)
+			list.push(val)
+			return id
+		}
+		const getList = () => [...list]
+		return { add, getList, }
+	}
+	
+	const bwTypeIndex = binaryWriter()
+	const bw = binaryWriter()
+		.u8(0)
+	const llTypeList = [0]
+	const ccNameList = createUnqList()
+	typeList.map((t, i) => {
+		bwTypeIndex.u32( t ? bw.getOffset() : 0 )
+		
+		if ( t ) {
+			assert( t.id === i )
+			
+			const typeID = assert( EnumTypeMap[ t.type ] )
+			
+			llTypeList.push( bw.getOffset() )
+
+			bw
+				.u8 ( typeID )
+				.u32( t.size )
+
+			t.nameID = t.name ? ccNameList.add(t.name) : 0
+			
+			if ( ['TypeVoid', 'TypeScalar'].includes(t.type) ) {
+				return bw
+					.u32( t.nameID           )
+					.u8 ( ( t.type === 'TypeScalar' ) ? ( EnumScalarKindMap[ t.name ] ?? 0 ) : 0 )
+			}
+
+			if ( ['TypeStruct', 'TypeClass', 'TypeUnion'].includes(t.type) ) {
+				return bw
+					.u32( t.nameID           )
+					.u32( t.fieldIdRng[0]    )
+					.u32( t.fieldIdRng[1]    )
+			}
+			
+			if ( ['TypeBitfield'].includes(t.type) ) {
+				return bw
+					.u32( t.elementTypeID    )
+					.u32( t.startingPosition )
+					.u32( t.bits             )
+			}
+			
+			if ( ['TypePointer', 'TypeArray'].includes(t.type) ) {
+				return bw
+					.u32( t.elementTypeID    )
+			}
+			
+			if ( ['TypeDataMemberField'].includes(t.type) ) {
+				return bw
+					.u32( t.elementTypeID    )
+					.u32( t.nameID           )
+					.u32( t.offset           )
+			}
+			
+			if ( ['TypeStaticDataMemberField', 'TypeVar'].includes(t.type) ) {
+				return bw
+					.u32( t.elementTypeID    )
+					.u32( t.nameID           )
+					.u64( t.address          )
+			}
+
+			assert( false )
+		}
+	})
+	Array(1024).fill(0).map( bw.u8 )
+
+	acReflectStructList(`constexpr int32_t __StructInfoCount = ${ typeList.length };`)
+
+	ccNameList
+		.getList()
+		.map(n => `"${ n ?? '' }", `)
+		.$next( createCodeArray('__StructInfoNameList')('constexpr const char*') )
+		.$next( acReflectStructList )
+
+	typeList
+		.filter(Boolean)
+		.filter(t => t.name && ( t.type !== 'TypeDataMemberField' ))
+		.map(t => ({ name: t.name, value: t.id, }))
+		.$next( buildPerfectHash )
+		.$next( ph => codePerfectHash('__StructInfoNameHash', ph) )
+		.$next( acReflectStructList )
+
+	typeList
+		.filter(Boolean)
+		.filter(t => ['TypeStruct', 'TypeClass', 'TypeUnion'].includes(t.type))
+		.map(t => Array(t.fieldIdRng[1])
+			.fill(0)
+			.map((_, i) => t.fieldIdRng[0] + i)
+			.map(id => ({ name: assert( typeList[id].name ), salt: t.id, value: id, })) )
+		.flat()
+		.$next( buildPerfectHash )
+		.$next( ph => codePerfectHash('__StructInfoFieldHash', ph) )
+		.$next( acReflectStructList )
+
+	bw
+		.getU64List()
+		.map(w => uintToHex(w, {padStart: 16}) + ', ')
+		.$next( createCodeArray('__StructInfoDataMemory')('constexpr uint64_t') )
+		.$next( acReflectStructList )
+	
+	bwTypeIndex
+		.getU64List()
+		.map(w => uintToHex(w, {padStart: 16}) + ', ')
+		.$next( createCodeArray('__StructInfoOffsetDataMemory')('constexpr uint64_t') )
+		.$next( acReflectStructList )
+
+	const acReflectStructDumpList = codeFrame()
+		.createFileFrame()
+		.createNamespaceFrame('Reflect')
+
+	typeList
+		.filter(Boolean)
+		.filter(t => ['TypeStruct', 'TypeClass', 'TypeUnion'].includes(t.type))
+		.map(t => [
+			`auto dumpStruct(const ${t.name}* pObj, const TStructDumperOptions& dumperOptions = {}) {`,
+			`return dumpStruct(getStructNode(${t.id}), (const uint8_t*)pObj, dumperOptions);`,
+			`}`,
+		].join(' '))
+		.map(acReflectStructDumpList)
+
+	typeList
+		.filter(Boolean)
+		.filter(t => ['TypeStruct', 'TypeClass', 'TypeUnion'].includes(t.type))
+		.map(t => `template<> struct NodeCppType< ${t.id}, EnumNodeType::${t.type} > { using type = ${t.name}; };`)
+		.map(acReflectStructDumpList)
+
+	return {
+		structInfoList: acReflectStructList.buildRoot(),
+		structInfo    : acReflectStructDumpList.buildRoot(),
+	}
+}
+/// funcList: [{ internalID, nameParts, address (Address), size, isStatic, isMethod }, ...] in internalID order
+/// Returns the code of Reflect/AG_FuncNameList.cpp and Reflect/AG_FuncInfoList.cpp
+export function codeReflectFuncList(funcList) {
+	const acReflectFuncNameList = codeFrame()
+		.createFileFrame()
+		.createNamespaceFrame('__Local__')
+
+	const acReflectFuncInfoList = codeFrame()
+		.createFileFrame()
+		.createNamespaceFrame('__Local__')
+
+	funcList
+		.map(f => `"${ f.nameParts.join('::') }",`)
+		.$next(createCodeArray('__FuncNameList')('const char*'))
+		.$next(acReflectFuncNameList)
+
+	const funcNameSortList = funcList
+		.map(f => ({ f, name: f.nameParts.join('::') }))
+		.map(e => ({ ...e, nameBuf: Buffer.from(e.name, 'utf-8') }))
+		.sort((l, r) => Buffer.compare(l.nameBuf, r.nameBuf) || ( l.f.internalID - r.f.internalID ))
+
+	funcNameSortList
+		.map(e => `${ e.f.internalID }, `)
+		.$next(l => l.length ? l : ['-1, '])
+		.$next(createCodeArray('__FuncNameSortList')('const int32_t'))
+		.$next(acReflectFuncNameList)
+
+	funcNameSortList
+		.map((e, i) => ({ name: e.name, value: i }))
+		.filter((e, i) => !i || ( funcNameSortList[i - 1].name !== e.name ))
+		.$next( buildPerfectHash )
+		.$next( ph => codePerfectHash('__FuncNameHash', ph) )
+		.$next( acReflectFuncNameList )
+
+	acReflectFuncInfoList(`const int32_t __FuncCount = ${ funcList.length };`)		
+		
+	funcList
+		.map(f => `${ cOptBld.castAddr(f.address) }, `)
+		.$next(createCodeArray('__FuncAddrList')('const uint64_t'))
+		.$next(acReflectFuncInfoList)
+
+	funcList
+		.map(f => `${ f.size }, `)
+		.$next(createCodeArray('__FuncSizeList')('const uint32_t'))
+		.$next(acReflectFuncInfoList)
+
+	const funcAddrIndexList = [...funcList]
+		.sort((l, r) => ( l.address.absAddress < r.address.absAddress ) ? -1 : ( ( l.address.absAddress > r.address.absAddress ) ? 1 : l.internalID - r.internalID ))
+		.$next(eytzingerLayout)
+
+	acReflectFuncInfoList(`const int32_t __FuncAddrIndexCount = ${ funcList.length };`)
+
+	funcAddrIndexList
+		.map(f => f ? `${ cOptBld.castAddr(f.address) }, ` : '0, ')
+		.$next(createCodeArray('__FuncAddrIndexList')('const uint64_t'))
+		.$next(acReflectFuncInfoList)
+
+	funcAddrIndexList
+		.map(f => f ? `${ f.internalID }, ` : '-1, ')
+		.$next(createCodeArray('__FuncAddrIndexIDList')('const int32_t'))
+		.$next(acReflectFuncInfoList)
+
+	funcList
+		.map(f => f.isStatic)
+		.$next(codeWriteBitsFlags(createCodeArray('__FuncIsStaticBitList')))
+		.$next(acReflectFuncInfoList)
+		
+	funcList
+		.map(f => f.isMethod)
+		.$next(codeWriteBitsFlags(createCodeArray('__FuncIsMethodBitList')))
+		.$next(acReflectFuncInfoList)
+
+	return {
+		funcNameList: acReflectFuncNameList.buildRoot(),
+		funcInfoList: acReflectFuncInfoList.buildRoot(),
+	}
+}
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 ////////////////////////////////////////
@@ -3769,13 +4111,6 @@ function AstProcessing(astBuilder, logger, outDir) {
 			`}`
 		) : code
 
-	const createCodeArray = arrName => itemType => list => list
-		.reduce((s, c) => s.addCell(c), buildRowsMaxRow(150))
-		.getRows()
-		.$next(buildLines)
-		.$next(fTextPadStart(GAP))
-		.$next(l => buildLines( `${itemType} ${arrName}[${list.length}] = {`, l, `};`, ) )
-
 	const accCodeFSBuilder = () => {
 		let list = []
 
@@ -3802,38 +4137,7 @@ function AstProcessing(astBuilder, logger, outDir) {
 	const getCTpl = n => fs.readFileSync('./CTpl/' + n, 'utf-8')
 	
 	function all_DumpCodeReflectModule() {
-		const acReflectModule = codeFrame()
-			.createFileFrame()
-			.createNamespaceFrame('Reflect')
-		
-		const i32u32 = n => (n = n|0, n < 0 ? (2**32) + n : n)
-
-		acReflectModule(`
-struct TSection {
-	bool         valid           = false;
-	uint64_t     rva             = 0;
-	uint64_t     size            = 0;
-	uint64_t     align           = 0;
-	uint64_t     characteristics = 0;
-	const char * name            = "";
-};`
-			.trim()
-		)
-		
-		acReflectModule(`constexpr uint64_t ATFSignature = {ATF_SIGNATURE_U64};`)
-		acReflectModule(`constexpr uint64_t BaseAddressExpected = ${ uintToHex(BaseAddressX64) };`)
-		astBuilder
-			.sectionMap
-			.map(s => (!s ? `TSection{},` : 
-				`TSection{ true, ${ uintToHex(s.rva) }, ${ uintToHex(s.size) }, ${ uintToHex(s.align) }, ${ uintToHex(i32u32(s.characteristics)) }, "${ s.name }" },`) )
-			.$next( buildLines )
-			.$next( fTextPadStart(GAP) )
-			.$next( s => buildLines( `constexpr std::array< TSection, ${ astBuilder.sectionMap.length } > Sections = {`, s, `};` ) )
-			.$next( acReflectModule )
-		
-		acReflectModule(`const uint64_t BaseAddress = (uint64_t)GetModuleHandleA(nullptr);`)
-		
-		accCodeFsBld.add('Reflect/AG_Module.hpp', acReflectModule.buildRoot())
+		accCodeFsBld.add('Reflect/AG_Module.hpp', codeReflectModule(astBuilder.sectionMap, BaseAddressX64))
 	}
 	function all_DumpCode() {
 		const alDepsSet = new Set()
@@ -4030,6 +4334,9 @@ struct TSection {
 				nameParts  : [...(n ? n.nameParts : []), ...f.nameParts],
 				elementType: f.elementType,
 				address    : f.address,
+				size       : parseInt(f.procInfo?.info?.cb ?? '0', 16) || 0,
+				isStatic   : !f.elementType.thisType,
+				isMethod   : !!f.elementType.check_(TypeMFunction),
 			})
 		}
 		
@@ -4082,55 +4389,18 @@ struct TSection {
 
 
 
-		const codeWriteBitsFlags = fCrtArr => bits => bits
-			.reduce((s, f, i) => s.setBit(i, f), bitsWordMgr(64))
-			.getWords()
-			.map(w => uintToHex(w, {padStart: 16}) + ', ')
-			.$next(fCrtArr('const uint64_t'))
-		
-		
 		function dump_ReflectInfo() {
-			const acReflectFuncNameList = codeFrame()
-				.createFileFrame()
-				.createNamespaceFrame('__Local__')
-
-			const acReflectFuncInfoList = codeFrame()
-				.createFileFrame()
-				.createNamespaceFrame('__Local__')
-
 			const acReflectFuncInfo = codeFrame()
 				.createFileFrame()
-				
-			funcList
-				.map(f => `"${ f.nameParts.join('::') }",`)
-				.$next(createCodeArray('__FuncNameList')('const char*'))
-				.$next(acReflectFuncNameList)
-
-			acReflectFuncInfoList(`const int32_t __FuncCount = ${ funcList.length };`)		
-				
-			funcList
-				.map(f => `${ cOptBld.castAddr(f.address) }, `)
-				.$next(createCodeArray('__FuncAddrList')('const uint64_t'))
-				.$next(acReflectFuncInfoList)
-
-			funcList
-				.map(f => !f.elementType.thisType)
-				.$next(codeWriteBitsFlags(createCodeArray('__FuncIsStaticBitList')))
-				.$next(acReflectFuncInfoList)
-				
-			funcList
-				.map(f => !!f.elementType.check_(TypeMFunction))
-				.$next(codeWriteBitsFlags(createCodeArray('__FuncIsMethodBitList')))
-				.$next(acReflectFuncInfoList)
-				
-				
+			
 			buildDeepFuncEx('FuncInfo', (m, i) => `static TFuncInfo ${ m.nameParts.at(-1) }${ i ? '$'+(i+1) : '' }() { return getFuncInfo(${ m.internalID }); } `)
 				.$next(acReflectFuncInfo.createNamespaceFrame('__Local__'))
 			
 			acReflectFuncInfo.createNamespaceFrame('Reflect')(`using FuncInfo = __Local__::FuncInfo;`)
 		
-			accCodeFsBld.add('Reflect/AG_FuncNameList.cpp', acReflectFuncNameList.buildRoot())
-			accCodeFsBld.add('Reflect/AG_FuncInfoList.cpp', acReflectFuncInfoList.buildRoot())
+			const codeFuncList = codeReflectFuncList(funcList)
+			accCodeFsBld.add('Reflect/AG_FuncNameList.cpp', codeFuncList.funcNameList)
+			accCodeFsBld.add('Reflect/AG_FuncInfoList.cpp', codeFuncList.funcInfoList)
 			accCodeFsBld.add('Reflect/AG_FuncInfo.cpp'    , acReflectFuncInfo.buildRoot())	
 		}
 		dump_ReflectInfo()
@@ -4443,146 +4713,9 @@ struct TSection {
 						[...n.nameParts, m.name].join('::'), 'TypeStaticDataMemberField', m.elementType.size, typeProcess(m.elementType), 0, { address: m.address.absAddress, }, true) )
 			})
 
-		const EnumTypeMap = {
-			TypeVoid    : 1, 
-			TypeScalar  : 2,
-			TypeBitfield: 3,			
-
-			TypePointer : 4,
-			TypeArray   : 5,
-			TypeStruct  : 6,
-			TypeClass   : 7,
-			TypeUnion   : 8,
-			
-			TypeDataMemberField: 10,
-			TypeStaticDataMemberField: 11,
-			
-			TypeVar: 12,
-		}
-
-		const acReflectStructList = codeFrame()
-			.createFileFrame()
-			.createNamespaceFrame('__Local__')
-			.createPackedFrame()
-
-		const createUnqList = () => {
-			const map = new Map()
-			const list = [null]
-			const add = val => {
-				if ( map.has(val) )
-					return map.get(val)
-				
-				const id = list.length
-				map.set(val, id)
-				list.push(val)
-				return id
-			}
-			const getList = () => [...list]
-			return { add, getList, }
-		}
-		
-		const bwTypeIndex = binaryWriter()
-		const bw = binaryWriter()
-			.u8(0)
-		const llTypeList = [0]
-		const ccNameList = createUnqList()
-		typeList.map((t, i) => {
-			bwTypeIndex.u32( t ? bw.getOffset() : 0 )
-			
-			if ( t ) {
-				assert( t.id === i )
-				
-				const typeID = assert( EnumTypeMap[ t.type ] )
-				
-				llTypeList.push( bw.getOffset() )
-
-				bw
-					.u8 ( typeID )
-					.u32( t.size )
-
-				t.nameID = t.name ? ccNameList.add(t.name) : 0
-				
-				if ( ['TypeVoid', 'TypeScalar'].includes(t.type) ) {
-					return bw
-						.u32( t.nameID           )
-				}
-
-				if ( ['TypeStruct', 'TypeClass', 'TypeUnion'].includes(t.type) ) {
-					return bw
-						.u32( t.nameID           )
-						.u32( t.fieldIdRng[0]    )
-						.u32( t.fieldIdRng[1]    )
-				}
-				
-				if ( ['TypeBitfield'].includes(t.type) ) {
-					return bw
-						.u32( t.elementTypeID    )
-						.u32( t.startingPosition )
-						.u32( t.bits             )
-				}
-				
-				if ( ['TypePointer', 'TypeArray'].includes(t.type) ) {
-					return bw
-						.u32( t.elementTypeID    )
-				}
-				
-				if ( ['TypeDataMemberField'].includes(t.type) ) {
-					return bw
-						.u32( t.elementTypeID    )
-						.u32( t.nameID           )
-						.u32( t.offset           )
-				}
-				
-				if ( ['TypeStaticDataMemberField', 'TypeVar'].includes(t.type) ) {
-					return bw
-						.u32( t.elementTypeID    )
-						.u32( t.nameID           )
-						.u64( t.address          )
-				}
-
-				assert( false )
-			}
-		})
-		Array(1024).fill(0).map( bw.u8 )
-
-		acReflectStructList(`const int32_t __StructInfoCount = ${ typeList.length };`)
-
-		ccNameList
-			.getList()
-			.map(n => `"${ n ?? '' }", `)
-			.$next( createCodeArray('__StructInfoNameList')('const char*') )
-			.$next( acReflectStructList )
-
-		bw
-			.getU64List()
-			.map(w => uintToHex(w, {padStart: 16}) + ', ')
-			.$next( createCodeArray('__StructInfoDataMemory')('const uint64_t') )
-			.$next( acReflectStructList )
-		
-		bwTypeIndex
-			.getU64List()
-			.map(w => uintToHex(w, {padStart: 16}) + ', ')
-			.$next( createCodeArray('__StructInfoOffsetDataMemory')('const uint64_t') )
-			.$next( acReflectStructList )
-		
-		accCodeFsBld.add('Reflect/AG_StructInfoList.cpp', acReflectStructList.buildRoot())
-
-
-		const acReflectStructDumpList = codeFrame()
-			.createFileFrame()
-			.createNamespaceFrame('Reflect')
-
-		typeList
-			.filter(Boolean)
-			.filter(t => ['TypeStruct', 'TypeClass', 'TypeUnion'].includes(t.type))
-			.map(t => [
-				`auto dumpStruct(const ${t.name}* pObj, const TStructDumperOptions& dumperOptions = {}) {`,
-				`return dumpStruct(getStructNode(${t.id}), (const uint8_t*)pObj, dumperOptions);`,
-				`}`,
-			].join(' '))
-			.map(acReflectStructDumpList)
-			
-		accCodeFsBld.add('Reflect/AG_StructInfo.cpp', acReflectStructDumpList.buildRoot())
+		const codeStructInfo = codeReflectStructInfo(typeList)
+		accCodeFsBld.add('Reflect/AG_StructInfoList.cpp', codeStructInfo.structInfoList)
+		accCodeFsBld.add('Reflect/AG_StructInfo.cpp'    , codeStructInfo.structInfo)
 	}
 	
 	function all_PostProcessCInclude() {
@@ -0,0 +1,174 @@
+import test from 'node:test'
+import assert from 'node:assert/strict'
+
+import { nameHash, buildPerfectHash, eytzingerLayout, } from '../Helpers.js'
+import { codeReflectStructInfo, codeReflectFuncList, } from './Builder.js'
+import { buildFixtureTypeList, buildFixtureFuncList, } from '../Tests/Fixture.js'
+
+/// node --test Builder/ (the C++ side of the same tables: Tests/Reflect)
+
+/// Same as perfectHashSlot (CInclude/Reflect/NameHash.cpp)
+const perfectHashSlot = (ph, name, salt = 0) => nameHash(name, ph.seedList[ nameHash(name, 0, salt) % ph.seedCount ], salt) % ph.slotCount
+
+/// Values of a generated `T name[N] = { ... };` array
+const parseCodeArray = (code, arrName) => {
+	const match = code.match(new RegExp(`${ arrName }\\[(\\d+)\\] = \\{([^}]*)\\}`))
+	assert.ok(match, arrName)
+
+	const list = match[2]
+		.split(',')
+		.map(s => s.trim())
+		.filter(Boolean)
+	assert.equal(list.length, +match[1])
+	return list
+}
+
+test('nameHash matches the C++ vectors', () => {
+	/// Tests/Reflect/main.cpp static_asserts the same values
+	assert.equal(nameHash('CPlayer', 0   ), 1586640619)
+	assert.equal(nameHash('CPlayer', 7, 3), 4190090293)
+	assert.equal(nameHash(''       , 0   ), 1234692987)
+	assert.equal(nameHash('m_nHP'  , 1, 3), 775403409 )
+})
+
+test('buildPerfectHash places every key in its own slot', () => {
+	for(const count of [1, 2, 3, 7, 64, 1000]) {
+		const keyList = Array(count)
+			.fill(0)
+			.map((_, i) => ({ name: `key_${ i }`, salt: i % 3, value: i * 10 }))
+		const ph = buildPerfectHash(keyList)
+
+		assert.equal(ph.slotCount, count)
+		assert.equal(ph.seedList.length, ph.seedCount)
+		keyList.map(k => assert.equal(ph.slotList[ perfectHashSlot(ph, k.name, k.salt) ], k.value, k.name))
+		assert.equal(new Set(ph.slotList).size, count)
+	}
+})
+
+test('buildPerfectHash keeps salted duplicates apart and rejects real duplicates', () => {
+	const ph = buildPerfectHash([{ name: 'x', salt: 1, value: 1 }, { name: 'x', salt: 2, value: 2 }])
+	assert.equal(ph.slotList[ perfectHashSlot(ph, 'x', 1) ], 1)
+	assert.equal(ph.slotList[ perfectHashSlot(ph, 'x', 2) ], 2)
+
+	assert.throws(() => buildPerfectHash([{ name: 'x', value: 1 }, { name: 'x', value: 2 }]))
+})
+
+test('eytzingerLayout is a BFS order of the sorted list', () => {
+	for(let count = 0; count < 70; count++) {
+		const sortedList = Array(count).fill(0).map((_, i) => i * 2)
+		const layout = eytzingerLayout(sortedList)
+
+		assert.equal(layout.length, count + 1)
+		assert.equal(layout[0], null)
+
+		const inOrder = []
+		const walk = k => k <= count && ( walk(2 * k), inOrder.push(layout[k]), walk(2 * k + 1) )
+		walk(1)
+		assert.deepEqual(inOrder, sortedList)
+
+		/// Branch free lower bound as in findFuncInternalIDByAddress (GetFuncInfo.cpp)
+		for(let v = -1; v <= count * 2; v++) {
+			let k = 1, best = 0
+			while( k <= count ) {
+				const right = layout[k] <= v
+				best = right ? k : best
+				k = 2 * k + ( right ? 1 : 0 )
+			}
+			const expected = sortedList.filter(x => x <= v).at(-1)
+			assert.equal(best ? layout[best] : undefined, expected, `count ${ count } value ${ v }`)
+		}
+	}
+})
+
+test('codeReflectStructInfo encodes the fixture records', () => {
+	const typeList = buildFixtureTypeList()
+	const code = codeReflectStructInfo(typeList).structInfoList
+
+	assert.match(code, new RegExp(`__StructInfoCount = ${ typeList.length };`))
+
+	const nameList = parseCodeArray(code, '__StructInfoNameList')
+		.map(s => JSON.parse(s))
+	assert.equal(nameList[0], '')
+	assert.equal(new Set(nameList).size, nameList.length)
+
+	const bytes = Buffer.concat(parseCodeArray(code, '__StructInfoDataMemory')
+		.map(s => { const b = Buffer.alloc(8); b.writeBigUInt64LE(BigInt(s)); return b }))
+	const indexBytes = Buffer.concat(parseCodeArray(code, '__StructInfoOffsetDataMemory')
+		.map(s => { const b = Buffer.alloc(8); b.writeBigUInt64LE(BigInt(s)); return b }))
+
+	/// Every record: u8 type, u32 size, then the name (or element type) id, see Node (GetStructInfo.cpp)
+	typeList
+		.filter(Boolean)
+		.map(t => {
+			const offset = indexBytes.readUInt32LE(t.id * 4)
+			assert.equal(bytes.readUInt32LE(offset + 1), t.size, `size of #${ t.id }`)
+
+			if ( [ 'TypeStruct', 'TypeUnion', 'TypeScalar' ].includes(t.type) )
+				assert.equal(nameList[ bytes.readUInt32LE(offset + 5) ], t.name)
+
+			if ( t.type === 'TypeStruct' || t.type === 'TypeUnion' ) {
+				assert.equal(bytes.readUInt32LE(offset +  9), t.fieldIdRng[0])
+				assert.equal(bytes.readUInt32LE(offset + 13), t.fieldIdRng[1])
+			}
+
+			if ( t.type === 'TypeDataMemberField' ) {
+				assert.equal(bytes.readUInt32LE(offset + 5), t.elementTypeID)
+				assert.equal(nameList[ bytes.readUInt32LE(offset + 9) ], t.name)
+				assert.equal(bytes.readUInt32LE(offset + 13), t.offset)
+			}
+
+			if ( t.type === 'TypeVar' || t.type === 'TypeStaticDataMemberField' )
+				assert.equal(bytes.readBigUInt64LE(offset + 13), t.address)
+		})
+
+	/// Struct names resolve through the emitted hash tables, fields by ( name, struct id )
+	const readHash = name => ({
+		seedCount: +code.match(new RegExp(`${ name }SeedCount = (\\d+);`))[1],
+		slotCount: +code.match(new RegExp(`${ name }SlotCount = (\\d+);`))[1],
+		seedList : parseCodeArray(code, `${ name }SeedList`).map(Number),
+		slotList : parseCodeArray(code, `${ name }SlotList`).map(Number),
+	})
+	const nameHashTable  = readHash('__StructInfoNameHash')
+	const fieldHashTable = readHash('__StructInfoFieldHash')
+
+	typeList
+		.filter(t => t && t.name && t.type !== 'TypeDataMemberField')
+		.map(t => assert.equal(nameHashTable.slotList[ perfectHashSlot(nameHashTable, t.name) ], t.id, t.name))
+
+	typeList
+		.filter(t => t && ( t.type === 'TypeStruct' || t.type === 'TypeUnion' ))
+		.map(t => Array(t.fieldIdRng[1])
+			.fill(0)
+			.map((_, i) => typeList[ t.fieldIdRng[0] + i ])
+			.map(f => assert.equal(fieldHashTable.slotList[ perfectHashSlot(fieldHashTable, f.name, t.id) ], f.id, `${ t.name }::${ f.name }`)) )
+})
+
+test('codeReflectFuncList emits the Eytzinger index and flag bits', () => {
+	const funcList = buildFixtureFuncList()
+	const { funcNameList, funcInfoList } = codeReflectFuncList(funcList)
+
+	const addrIndexList   = parseCodeArray(funcInfoList, '__FuncAddrIndexList').map(BigInt)
+	const addrIndexIDList = parseCodeArray(funcInfoList, '__FuncAddrIndexIDList').map(Number)
+	assert.equal(addrIndexList.length, funcList.length + 1)
+
+	addrIndexIDList
+		.slice(1)
+		.map((id, i) => assert.equal(addrIndexList[ i + 1 ], funcList[id].address.absAddress))
+
+	const inOrder = []
+	const walk = k => k <= funcList.length && ( walk(2 * k), inOrder.push(addrIndexList[k]), walk(2 * k + 1) )
+	walk(1)
+	assert.deepEqual(inOrder, [...inOrder].sort((l, r) => ( l < r ) ? -1 : ( l > r ) ? 1 : 0))
+
+	const bits = list => BigInt(parseCodeArray(funcInfoList, list)[0])
+	funcList.map(f => {
+		assert.equal(!!( ( bits('__FuncIsStaticBitList') >> BigInt(f.internalID) ) & 1n ), f.isStatic)
+		assert.equal(!!( ( bits('__FuncIsMethodBitList') >> BigInt(f.internalID) ) & 1n ), f.isMethod)
+	})
+
+	/// Name sort order is byte order, overloads stay in internalID order
+	const sortList = parseCodeArray(funcNameList, '__FuncNameSortList').map(Number)
+	const names = sortList.map(id => funcList[id].nameParts.join('::'))
+	assert.deepEqual(names, [...names].sort())
+	assert.deepEqual(sortList.filter(id => names[ sortList.indexOf(id) ] === 'CPlayer::Attack'), [0, 4])
+})
\ No newline at end of file
@@ -1,13 +1,37 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdio>
 #include <cassert>
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <list>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <tuple>
+#include <unordered_set>
 #include <vector>
 
-#include "windows.h"
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+#if __cplusplus >= 201703L || ( defined(_MSVC_LANG) && _MSVC_LANG >= 201703L )
+	#include <charconv>
+#endif
+
+#ifdef _WIN32
+	#include "windows.h"
+#endif
 
 #include "Types.hpp"
 #include "Structs.cpp"
@@ -28,6 +52,8 @@
 #endif
 
 #ifndef ATF_COMPILE_WITHOUT_REFLECT
+	#include "Reflect/NameHash.cpp"
+
 	#ifndef ATF_COMPILE_WITHOUT_REFLECT_FUNC_NAMES
 		#include "Reflect/AG_FuncNameList.cpp"
 	#endif
@@ -42,6 +68,7 @@
 	#ifdef ATF_COMPILE_WITH_REFLECT_STRUCT_INFO
 		#include "Reflect/AG_StructInfoList.cpp"
 		#include "Reflect/GetStructInfo.cpp"
+		#include "Reflect/StaticStructInfo.cpp"
 		#include "Reflect/StructDumper.cpp"
 		
 		#ifndef ATF_COMPILE_WITHOUT_REFLECT_STRUCT_INFO
@@ -11,6 +11,7 @@ namespace ATF {
 			bool        isMethod = false;
 			uint64_t    address  = 0;
 			const char* name     = "";
+			uint32_t    size     = 0;
 		};
 		#pragma pack(pop)
 
@@ -42,16 +43,125 @@ namespace ATF {
 				__getBit(__Local__::__FuncIsMethodBitList, internalID),
 				__Local__::__FuncAddrList[internalID],
 				pFuncName,
+				__Local__::__FuncSizeList[internalID],
 			};
 		}
+
+		/// Position before k (1-based) in the sorted order of an Eytzinger layout of count entries, 0 for the first one
+		size_t __eytzingerPrev(size_t k, const size_t count) {
+			if ( 2 * k <= count ) {
+				for(k = 2 * k; 2 * k + 1 <= count; k = 2 * k + 1) ;
+				return k;
+			}
+
+			while( !( k & 1 ) )
+				k >>= 1;
+			return k >> 1;
+		}
+
+		/// Eytzinger ordered __FuncAddrIndexList: greatest start address <= address, then address must lie in [start, start + size).
+		/// Size 0 (no procedure record) covers only the start address itself. Such symbols inside a function (labels, publics) are skipped,
+		/// the search goes back in address order up to the first sized entry (sized functions do not overlap)
+		int32_t findFuncInternalIDByAddress(const uint64_t address) {
+			const size_t count = static_cast< size_t >( __Local__::__FuncAddrIndexCount );
+
+			size_t k    = 1;
+			size_t best = 0;
+			while( k <= count ) {
+				const bool right = __Local__::__FuncAddrIndexList[ k ] <= address;
+				best = right ? k : best;
+				k = 2 * k + ( right ? 1 : 0 );
+			}
+
+			for(; best; best = __eytzingerPrev(best, count)) {
+				const int32_t  internalID = __Local__::__FuncAddrIndexIDList[ best ];
+				const uint64_t start      = __Local__::__FuncAddrIndexList[ best ];
+				const uint64_t size       = __Local__::__FuncSizeList[ internalID ];
+				if ( size )
+					return ( address - start < size ) ? internalID : -1;
+
+				if ( address == start )
+					return internalID;
+			}
+
+			return -1;
+		}
 	}
 	namespace Reflect {
 		using TFuncInfo = __Local__::TFuncInfo;
 
+		/// Function containing address, invalid for addresses outside every function (other modules, data).
+		/// A function without size is found only by its start address
+		TFuncInfo findFuncByAddress(const uint64_t address) {
+			const int32_t internalID = __Local__::findFuncInternalIDByAddress(address);
+			if ( internalID < 0 )
+				return TFuncInfo{ false, internalID };
+
+			return __Local__::getFuncInfo(internalID);
+		}
+
 		template< class TFun >
 		void eachFuncInfo(TFun f) {
 			for(int32_t i = 0; i < __Local__::__FuncCount; i++)
 				f( __Local__::getFuncInfo(i) );
 		}
+
+		#ifndef ATF_COMPILE_WITHOUT_REFLECT_FUNC_NAMES
+			/// __FuncNameSortList: internalIDs sorted by name (strcmp order), the name hash points at the first entry of each name
+			template< class TFun >
+			void eachFuncByName(const char* pName, TFun f) {
+				if ( !pName )
+					return;
+
+				const int32_t slot = __Local__::perfectHashSlot(pName, 0, 
+					__Local__::__FuncNameHashSeedList, __Local__::__FuncNameHashSeedCount, __Local__::__FuncNameHashSlotCount);
+				if ( slot < 0 )
+					return;
+
+				for(int32_t i = __Local__::__FuncNameHashSlotList[ slot ]; i < __Local__::__FuncCount; i++) {
+					const int32_t internalID = __Local__::__FuncNameSortList[ i ];
+					if ( strcmp(__Local__::__FuncNameList[ internalID ], pName) )
+						break;
+
+					f( __Local__::getFuncInfo(internalID) );
+				}
+			}
+
+			/// First (lowest internalID) of the overloads
+			TFuncInfo findFuncByName(const char* pName) {
+				TFuncInfo info{ false, -1 };
+				eachFuncByName(pName, [&](const TFuncInfo& f) {
+					if ( !info.valid )
+						info = f;
+				});
+				return info;
+			}
+
+			/// eachFuncWithPrefix("CPlayer::", ...) - all methods of CPlayer, in name order
+			template< class TFun >
+			void eachFuncWithPrefix(const char* pPrefix, TFun f) {
+				if ( !pPrefix )
+					return;
+
+				int32_t l = 0;
+				int32_t r = __Local__::__FuncCount;
+				while( l < r ) {
+					const int32_t m = l + ( r - l ) / 2;
+					if ( strcmp(__Local__::__FuncNameList[ __Local__::__FuncNameSortList[ m ] ], pPrefix) < 0 )
+						l = m + 1;
+					else
+						r = m;
+				}
+
+				const size_t prefixLen = strlen(pPrefix);
+				for(int32_t i = l; i < __Local__::__FuncCount; i++) {
+					const int32_t internalID = __Local__::__FuncNameSortList[ i ];
+					if ( strncmp(__Local__::__FuncNameList[ internalID ], pPrefix, prefixLen) )
+						break;
+
+					f( __Local__::getFuncInfo(internalID) );
+				}
+			}
+		#endif
 	}
 }
\ No newline at end of file
@@ -20,12 +20,64 @@ namespace ATF {
 			TypeVar = 12,
 		};
 
+		/// TypeScalar value kind, see EnumScalarKindMap (Builder.js)
+		enum class EnumScalarKind : uint8_t {
+			None    = 0,
+
+			Int8    = 1,
+			Int16   = 2,
+			Int32   = 3,
+			Int64   = 4,
+
+			UInt8   = 5,
+			UInt16  = 6,
+			UInt32  = 7,
+			UInt64  = 8,
+
+			Float32 = 9,
+			Float64 = 10,
+
+			Bool    = 11,
+			Char    = 12,
+			UChar16 = 13,
+			HRESULT = 14,
+		};
+		constexpr uint32_t scalarKindSize(const EnumScalarKind eScalarKind) {
+			switch( eScalarKind ) {
+				case EnumScalarKind::Int8   :
+				case EnumScalarKind::UInt8  :
+				case EnumScalarKind::Bool   :
+				case EnumScalarKind::Char   : return 1;
+
+				case EnumScalarKind::Int16  :
+				case EnumScalarKind::UInt16 :
+				case EnumScalarKind::UChar16: return 2;
+
+				case EnumScalarKind::Int32  :
+				case EnumScalarKind::UInt32 :
+				case EnumScalarKind::Float32:
+				case EnumScalarKind::HRESULT: return 4;
+
+				case EnumScalarKind::Int64  :
+				case EnumScalarKind::UInt64 :
+				case EnumScalarKind::Float64: return 8;
+
+				default:
+					break;
+			}
+			return 0;
+		}
+		constexpr bool scalarKindIsInt(const EnumScalarKind eScalarKind) {
+			return ( EnumScalarKind::Int8 <= eScalarKind ) && ( eScalarKind <= EnumScalarKind::UInt64 );
+		}
+
 		struct Node {
 			EnumNodeType eNodeType = (EnumNodeType)0xFF;
 			uint32_t     size;
 			
 			struct NodeScalar {
-				int32_t nameID;
+				int32_t        nameID;
+				EnumScalarKind eScalarKind;
 			};
 			struct NodeStruct {
 				int32_t nameID;
@@ -85,69 +137,208 @@ namespace ATF {
 			
 			return __Local__::__StructInfoNameList[ id ];
 		}
-		const Node  getStructNode(const int32_t nodeInternalID) {
+
+		/// Node record in place: __StructInfoDataMemory (or a fake Node of StructNodeExtends), no copy.
+		/// Only eNodeType, size and the union are readable through _pNode, the record ends there.
+		class NodeView {
+			private:
+				const Node* _pNode = nullptr;
+				int32_t     _id    = 0;
+
+			public:
+				NodeView() {}
+				NodeView(const Node* pNode, const int32_t id) : _pNode(pNode), _id(id) {}
+
+				bool         valid() const { return _pNode != nullptr; }
+				int32_t      id   () const { return _id; }
+				EnumNodeType type () const { return valid() ? _pNode->eNodeType : (EnumNodeType)0xFF; }
+				uint32_t     size () const { return valid() ? _pNode->size : 0; }
+
+				bool isStruct() const {
+					return 
+						( type() == EnumNodeType::TypeStruct ) ||
+						( type() == EnumNodeType::TypeClass  ) ||
+						( type() == EnumNodeType::TypeUnion  );
+				}
+
+				int32_t nameID() const {
+					switch( type() ) {
+						case EnumNodeType::TypeVoid                 : return _pNode->typeVoid           .nameID;
+						case EnumNodeType::TypeScalar               : return _pNode->typeScalar         .nameID;
+						case EnumNodeType::TypeStruct               : return _pNode->typeStruct         .nameID;
+						case EnumNodeType::TypeClass                : return _pNode->typeStruct         .nameID;
+						case EnumNodeType::TypeUnion                : return _pNode->typeStruct         .nameID;
+						case EnumNodeType::TypeDataMemberField      : return _pNode->typeDataMemberField.nameID;
+						case EnumNodeType::TypeStaticDataMemberField: return _pNode->typeVar            .nameID;
+						case EnumNodeType::TypeVar                  : return _pNode->typeVar            .nameID;
+						default:
+							break;
+					}
+					return 0;
+				}
+				const char* name() const { return getStructNodeName( nameID() ); }
+
+				int32_t elementTypeID() const {
+					switch( type() ) {
+						case EnumNodeType::TypeBitfield             : return _pNode->typeBitfield       .elementTypeID;
+						case EnumNodeType::TypePointer              : return _pNode->typePointer        .elementTypeID;
+						case EnumNodeType::TypeArray                : return _pNode->typeArray          .elementTypeID;
+						case EnumNodeType::TypeDataMemberField      : return _pNode->typeDataMemberField.elementTypeID;
+						case EnumNodeType::TypeStaticDataMemberField: return _pNode->typeVar            .elementTypeID;
+						case EnumNodeType::TypeVar                  : return _pNode->typeVar            .elementTypeID;
+						default:
+							break;
+					}
+					return 0;
+				}
+
+				EnumScalarKind scalarKind() const { return ( type() == EnumNodeType::TypeScalar ) ? _pNode->typeScalar.eScalarKind : EnumScalarKind::None; }
+
+				uint32_t offset          () const { return ( type() == EnumNodeType::TypeDataMemberField ) ? _pNode->typeDataMemberField.offset : 0; }
+				uint64_t address         () const { return ( type() == EnumNodeType::TypeVar || type() == EnumNodeType::TypeStaticDataMemberField ) ? _pNode->typeVar.address : 0; }
+				uint32_t startingPosition() const { return ( type() == EnumNodeType::TypeBitfield ) ? _pNode->typeBitfield.startingPosition : 0; }
+				uint32_t bits            () const { return ( type() == EnumNodeType::TypeBitfield ) ? _pNode->typeBitfield.bits : 0; }
+				int32_t  fieldStartID    () const { return isStruct() ? _pNode->typeStruct.fieldStartID : 0; }
+				int32_t  fieldCount      () const { return isStruct() ? _pNode->typeStruct.fieldCount   : 0; }
+
+				Node toNode() const {
+					if ( !valid() )
+						return Node{};
+
+					Node node = *_pNode;
+					node.name  = name();
+					node.valid = true;
+					node.id    = _id;
+					return node;
+				}
+				operator Node() const { return toNode(); }
+		};
+
+		const NodeView getStructNodeView(const int32_t nodeInternalID) {
 			if ( nodeInternalID < 0 )
-				return Node{};
+				return NodeView{};
 			
 			if ( nodeInternalID >= __Local__::__StructInfoCount )
-				return Node{};
+				return NodeView{};
 			
 			if ( !nodeInternalID )
-				return Node{};
+				return NodeView{};
 
 			const uint32_t* pOffsetList = reinterpret_cast< const uint32_t* >( &__Local__::__StructInfoOffsetDataMemory[0] );
 			const uint32_t offset = pOffsetList[ nodeInternalID ];
 			
 			const uint8_t* pData = reinterpret_cast< const uint8_t* >( &__Local__::__StructInfoDataMemory[0] );
 
-			Node node = *( reinterpret_cast< const Node* >( &pData[ offset ] ) );
-			node.name = "";
-
-			switch( node.eNodeType ) {
-				case EnumNodeType::TypeVoid                 : node.name = getStructNodeName(node.typeVoid           .nameID); break;
-				case EnumNodeType::TypeScalar               : node.name = getStructNodeName(node.typeScalar         .nameID); break;
-				case EnumNodeType::TypeStruct               : node.name = getStructNodeName(node.typeStruct         .nameID); break;
-				case EnumNodeType::TypeClass                : node.name = getStructNodeName(node.typeStruct         .nameID); break;
-				case EnumNodeType::TypeUnion                : node.name = getStructNodeName(node.typeStruct         .nameID); break;
-				case EnumNodeType::TypeDataMemberField      : node.name = getStructNodeName(node.typeDataMemberField.nameID); break;
-				case EnumNodeType::TypeStaticDataMemberField: node.name = getStructNodeName(node.typeVar            .nameID); break;
-				case EnumNodeType::TypeVar                  : node.name = getStructNodeName(node.typeVar            .nameID); break;
-				default:
-					break;
-			}
-			
-			node.valid = true;
-			node.id = nodeInternalID;
-			
-			return node;
+			return NodeView{ reinterpret_cast< const Node* >( &pData[ offset ] ), nodeInternalID };
+		}
+		/// Static nodes resolve to the blob, a fake node (StructNodeExtends) is viewed in place:
+		/// the view is valid only while node lives, prefer StructNodeExtends::getNodeView(id)
+		const NodeView getStructNodeView(const Node& node) {
+			if ( !node.valid )
+				return NodeView{};
+
+			const auto view = getStructNodeView(node.id);
+			return view.valid() ? view : NodeView{ &node, node.id };
+		}
+		const NodeView getStructNodeView(const Node&& node) = delete;
+		const Node  getStructNode(const int32_t nodeInternalID) {
+			return getStructNodeView(nodeInternalID).toNode();
+		}
+
+		class NodeViewRange {
+			private:
+				int32_t _beginID = 0;
+				int32_t _endID   = 0;
+
+			public:
+				struct iterator {
+					int32_t id = 0;
+
+					NodeView  operator* () const { return getStructNodeView(id); }
+					iterator& operator++() { id++; return *this; }
+					bool      operator!=(const iterator& other) const { return id != other.id; }
+				};
+
+				NodeViewRange(const int32_t beginID = 0, const int32_t endID = 0) : _beginID(beginID), _endID(endID) {}
+
+				iterator begin() const { return { _beginID }; }
+				iterator end  () const { return { _endID   }; }
+				int32_t  size () const { return _endID - _beginID; }
+		};
+		NodeViewRange fields(const NodeView& node) {
+			if ( !node.isStruct() )
+				return NodeViewRange{};
+
+			return NodeViewRange{ node.fieldStartID(), node.fieldStartID() + node.fieldCount() };
+		}
+		NodeViewRange fields(const Node& node) {
+			return fields( getStructNodeView(node) );
+		}
+		NodeViewRange structNodes() {
+			return NodeViewRange{ 1, __Local__::__StructInfoCount };
+		}
+
+		const Node  findStructNodeByName(const char* pName) {
+			if ( !pName )
+				return Node{};
+
+			const int32_t slot = __Local__::perfectHashSlot(pName, 0, 
+				__Local__::__StructInfoNameHashSeedList, __Local__::__StructInfoNameHashSeedCount, __Local__::__StructInfoNameHashSlotCount);
+			if ( slot < 0 )
+				return Node{};
+
+			const auto view = getStructNodeView( __Local__::__StructInfoNameHashSlotList[ slot ] );
+			if ( !view.valid() || strcmp(view.name(), pName) )
+				return Node{};
+
+			return view.toNode();
+		}
+
+		const NodeView findStructFieldView(const NodeView& node, const char* pFieldName) {
+			if ( !node.isStruct() || !pFieldName )
+				return NodeView{};
+
+			const int32_t slot = __Local__::perfectHashSlot(pFieldName, static_cast< uint32_t >( node.id() ), 
+				__Local__::__StructInfoFieldHashSeedList, __Local__::__StructInfoFieldHashSeedCount, __Local__::__StructInfoFieldHashSlotCount);
+			if ( slot < 0 )
+				return NodeView{};
+
+			const int32_t fieldID = __Local__::__StructInfoFieldHashSlotList[ slot ];
+			if ( !( ( node.fieldStartID() <= fieldID ) && ( fieldID < node.fieldStartID() + node.fieldCount() ) ) )
+				return NodeView{};
+
+			const auto fieldNode = getStructNodeView(fieldID);
+			if ( !fieldNode.valid() || strcmp(fieldNode.name(), pFieldName) )
+				return NodeView{};
+
+			return fieldNode;
+		}
+		const Node  findStructField(const Node& node, const char* pFieldName) {
+			return findStructFieldView( getStructNodeView(node), pFieldName ).toNode();
+		}
+
+		/// fun(NodeView), no copy of the records
+		template< class TFun >
+		void eachStructFieldView(const NodeView& node, const TFun fun) {
+			for(const auto fieldNode : fields(node))
+				if ( fieldNode.valid() )
+					fun(fieldNode);
 		}
-		
 		template< class TFun >
 		void eachStructField(const Node& node, const TFun fun) {
-			if ( !node.valid )
-				return;
-			
-			if ( !(
-				( node.eNodeType == EnumNodeType::TypeStruct ) ||
-				( node.eNodeType == EnumNodeType::TypeClass  ) ||
-				( node.eNodeType == EnumNodeType::TypeUnion  )
-			) )
-				return;
-
-			for(int32_t id = node.typeStruct.fieldStartID; id < node.typeStruct.fieldStartID + node.typeStruct.fieldCount; id++) {
-				const auto node = getStructNode(id);
-				if ( node.valid )
-					fun(node);
-			}
+			eachStructFieldView(getStructNodeView(node), [&](const NodeView& fieldNode) { fun( fieldNode.toNode() ); });
 		}
 
+		/// fun(NodeView), no copy of the records
 		template< class TFun >
-		void eachStructNode(const TFun fun) {
-			for(int32_t id = 0; id < __Local__::__StructInfoCount; id++) {
-				const auto node = getStructNode(id);
-				if ( node.valid )
+		void eachStructNodeView(const TFun fun) {
+			for(const auto node : structNodes())
+				if ( node.valid() )
 					fun(node);
-			}
+		}
+		template< class TFun >
+		void eachStructNode(const TFun fun) {
+			eachStructNodeView([&](const NodeView& node) { fun( node.toNode() ); });
 		}
 		
 		#pragma pack(pop)
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace ATF {
+	namespace __Local__ {
+
+		/// Must match nameHashBytes (Helpers.js)
+		constexpr uint32_t nameHash(const char* pName, const uint32_t seed, const uint32_t salt = 0) {
+			uint32_t h = 2166136261u ^ seed;
+
+			for(uint32_t i = 0; i < 4; i++)
+				h = ( h ^ ( ( salt >> (i * 8) ) & 0xFF ) ) * 16777619u;
+
+			for(; *pName; pName++)
+				h = ( h ^ static_cast< uint8_t >( *pName ) ) * 16777619u;
+
+			h = ( h ^ (h >> 16) ) * 0x85EBCA6Bu;
+			h = ( h ^ (h >> 13) ) * 0xC2B2AE35u;
+			return h ^ (h >> 16);
+		}
+
+		/// Minimal perfect hash slot, see buildPerfectHash (Helpers.js). Caller must verify the key stored in the slot
+		constexpr int32_t perfectHashSlot(const char* pName, const uint32_t salt, const uint32_t* pSeedList, const int32_t seedCount, const int32_t slotCount) {
+			if ( ( seedCount <= 0 ) || ( slotCount <= 0 ) )
+				return -1;
+
+			const uint32_t seed = pSeedList[ nameHash(pName, 0, salt) % static_cast< uint32_t >( seedCount ) ];
+			return static_cast< int32_t >( nameHash(pName, seed, salt) % static_cast< uint32_t >( slotCount ) );
+		}
+
+	}
+}
\ No newline at end of file
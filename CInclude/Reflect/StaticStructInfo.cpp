@@ -0,0 +1,219 @@
+#pragma once
+
+namespace ATF {
+	namespace Reflect {
+		/// Compile-time decoding of __StructInfoDataMemory, record layout see GetStructInfo.cpp (Node, packed)
+		namespace StaticStructInfo {
+
+			constexpr uint32_t InvalidOffset = 0xFFFFFFFF;
+
+			constexpr uint8_t  readU8 (const uint64_t offset) { return static_cast< uint8_t >( __Local__::__StructInfoDataMemory[ offset / 8 ] >> ( ( offset % 8 ) * 8 ) ); }
+			constexpr uint32_t readU32(const uint64_t offset) {
+				return
+					( static_cast< uint32_t >( readU8(offset + 0) ) <<  0 ) |
+					( static_cast< uint32_t >( readU8(offset + 1) ) <<  8 ) |
+					( static_cast< uint32_t >( readU8(offset + 2) ) << 16 ) |
+					( static_cast< uint32_t >( readU8(offset + 3) ) << 24 ) ;
+			}
+
+			constexpr bool validID(const int32_t id) { return ( 0 < id ) && ( id < __Local__::__StructInfoCount ); }
+
+			constexpr uint64_t recordOffset(const int32_t id) {
+				return static_cast< uint32_t >( __Local__::__StructInfoOffsetDataMemory[ id / 2 ] >> ( ( id % 2 ) * 32 ) );
+			}
+			/// i-th u32 of the union
+			constexpr uint32_t unionU32(const int32_t id, const uint32_t i) { return readU32( recordOffset(id) + 1 + 4 + i * 4 ); }
+
+			constexpr EnumNodeType nodeType(const int32_t id) { return validID(id) ? static_cast< EnumNodeType >( readU8( recordOffset(id) ) ) : (EnumNodeType)0xFF; }
+			constexpr uint32_t     nodeSize(const int32_t id) { return validID(id) ? readU32( recordOffset(id) + 1 ) : 0; }
+
+			constexpr bool isStruct(const int32_t id) {
+				return
+					( nodeType(id) == EnumNodeType::TypeStruct ) ||
+					( nodeType(id) == EnumNodeType::TypeClass  ) ||
+					( nodeType(id) == EnumNodeType::TypeUnion  );
+			}
+
+			constexpr int32_t nameID(const int32_t id) {
+				switch( nodeType(id) ) {
+					case EnumNodeType::TypeVoid                 :
+					case EnumNodeType::TypeScalar               :
+					case EnumNodeType::TypeStruct               :
+					case EnumNodeType::TypeClass                :
+					case EnumNodeType::TypeUnion                : return static_cast< int32_t >( unionU32(id, 0) );
+					case EnumNodeType::TypeDataMemberField      :
+					case EnumNodeType::TypeStaticDataMemberField:
+					case EnumNodeType::TypeVar                  : return static_cast< int32_t >( unionU32(id, 1) );
+					default:
+						break;
+				}
+				return 0;
+			}
+			constexpr const char* name(const int32_t id) { return ( nameID(id) > 0 ) ? __Local__::__StructInfoNameList[ nameID(id) ] : ""; }
+
+			constexpr int32_t elementTypeID(const int32_t id) {
+				switch( nodeType(id) ) {
+					case EnumNodeType::TypeBitfield             :
+					case EnumNodeType::TypePointer              :
+					case EnumNodeType::TypeArray                :
+					case EnumNodeType::TypeDataMemberField      :
+					case EnumNodeType::TypeStaticDataMemberField:
+					case EnumNodeType::TypeVar                  : return static_cast< int32_t >( unionU32(id, 0) );
+					default:
+						break;
+				}
+				return 0;
+			}
+			constexpr uint32_t fieldOffset (const int32_t id) { return ( nodeType(id) == EnumNodeType::TypeDataMemberField ) ? unionU32(id, 2) : 0; }
+			constexpr int32_t  fieldStartID(const int32_t id) { return isStruct(id) ? static_cast< int32_t >( unionU32(id, 1) ) : 0; }
+			constexpr int32_t  fieldCount  (const int32_t id) { return isStruct(id) ? static_cast< int32_t >( unionU32(id, 2) ) : 0; }
+
+			constexpr bool strEqual(const char* pL, const char* pR) {
+				for(; *pL && ( *pL == *pR ); pL++, pR++) ;
+				return *pL == *pR;
+			}
+
+			constexpr int32_t findNodeIDByName(const char* pName) {
+				const int32_t slot = __Local__::perfectHashSlot(pName, 0,
+					__Local__::__StructInfoNameHashSeedList, __Local__::__StructInfoNameHashSeedCount, __Local__::__StructInfoNameHashSlotCount);
+				if ( slot < 0 )
+					return 0;
+
+				const int32_t id = __Local__::__StructInfoNameHashSlotList[ slot ];
+				return ( validID(id) && strEqual(name(id), pName) ) ? id : 0;
+			}
+			constexpr int32_t findFieldID(const int32_t structID, const char* pFieldName) {
+				if ( !isStruct(structID) )
+					return 0;
+
+				const int32_t slot = __Local__::perfectHashSlot(pFieldName, static_cast< uint32_t >( structID ),
+					__Local__::__StructInfoFieldHashSeedList, __Local__::__StructInfoFieldHashSeedCount, __Local__::__StructInfoFieldHashSlotCount);
+				if ( slot < 0 )
+					return 0;
+
+				const int32_t id = __Local__::__StructInfoFieldHashSlotList[ slot ];
+				if ( !( ( fieldStartID(structID) <= id ) && ( id < fieldStartID(structID) + fieldCount(structID) ) ) )
+					return 0;
+
+				return strEqual(name(id), pFieldName) ? id : 0;
+			}
+
+			/// "a.b.c" through embedded struct members, result is the last field node id (0 if not found)
+			struct TFieldPath {
+				int32_t  fieldID = 0;
+				uint32_t offset  = InvalidOffset;
+			};
+			constexpr TFieldPath findFieldPath(const char* pStructName, const char* pFieldPath) {
+				TFieldPath path{};
+
+				int32_t  structID = findNodeIDByName(pStructName);
+				uint32_t offset   = 0;
+				while( true ) {
+					char part[256] = {};
+					size_t len = 0;
+					for(; *pFieldPath && ( *pFieldPath != '.' ); pFieldPath++) {
+						if ( len + 1 >= sizeof(part) )
+							return path;
+						part[ len++ ] = *pFieldPath;
+					}
+
+					const int32_t fieldID = findFieldID(structID, part);
+					if ( !fieldID )
+						return path;
+
+					offset += fieldOffset(fieldID);
+
+					if ( !*pFieldPath ) {
+						path.fieldID = fieldID;
+						path.offset  = offset;
+						return path;
+					}
+
+					pFieldPath++;
+					structID = elementTypeID(fieldID);
+				}
+			}
+
+			constexpr EnumScalarKind scalarKind(const int32_t id) {
+				return ( nodeType(id) == EnumNodeType::TypeScalar ) ? static_cast< EnumScalarKind >( readU8( recordOffset(id) + 1 + 4 + 4 ) ) : EnumScalarKind::None;
+			}
+			template< EnumScalarKind eScalarKind > struct ScalarCppType {};
+			template<> struct ScalarCppType< EnumScalarKind::Int8    > { using type = int8_t   ; };
+			template<> struct ScalarCppType< EnumScalarKind::Int16   > { using type = int16_t  ; };
+			template<> struct ScalarCppType< EnumScalarKind::Int32   > { using type = int32_t  ; };
+			template<> struct ScalarCppType< EnumScalarKind::Int64   > { using type = int64_t  ; };
+			template<> struct ScalarCppType< EnumScalarKind::UInt8   > { using type = uint8_t  ; };
+			template<> struct ScalarCppType< EnumScalarKind::UInt16  > { using type = uint16_t ; };
+			template<> struct ScalarCppType< EnumScalarKind::UInt32  > { using type = uint32_t ; };
+			template<> struct ScalarCppType< EnumScalarKind::UInt64  > { using type = uint64_t ; };
+			template<> struct ScalarCppType< EnumScalarKind::Float32 > { using type = float32_t; };
+			template<> struct ScalarCppType< EnumScalarKind::Float64 > { using type = float64_t; };
+			template<> struct ScalarCppType< EnumScalarKind::Bool    > { using type = bool     ; };
+			template<> struct ScalarCppType< EnumScalarKind::Char    > { using type = char     ; };
+			template<> struct ScalarCppType< EnumScalarKind::UChar16 > { using type = uchar16_t; };
+			template<> struct ScalarCppType< EnumScalarKind::HRESULT > { using type = HRESULT  ; };
+		}
+
+		constexpr uint32_t offsetOf(const char* pStructName, const char* pFieldPath) {
+			return StaticStructInfo::findFieldPath(pStructName, pFieldPath).offset;
+		}
+		constexpr int32_t fieldTypeID(const char* pStructName, const char* pFieldPath) {
+			return StaticStructInfo::elementTypeID( StaticStructInfo::findFieldPath(pStructName, pFieldPath).fieldID );
+		}
+
+		/// C++ type of a node, struct types are specialized in AG_StructInfo.cpp
+		template< int32_t nodeID, EnumNodeType eNodeType = StaticStructInfo::nodeType(nodeID) >
+		struct NodeCppType {};
+
+		template< int32_t nodeID >
+		struct NodeCppType< nodeID, EnumNodeType::TypeVoid > { using type = void; };
+
+		template< int32_t nodeID >
+		struct NodeCppType< nodeID, EnumNodeType::TypeScalar > { using type = typename StaticStructInfo::ScalarCppType< StaticStructInfo::scalarKind(nodeID) >::type; };
+
+		template< int32_t nodeID >
+		struct NodeCppType< nodeID, EnumNodeType::TypeBitfield > { using type = typename NodeCppType< StaticStructInfo::elementTypeID(nodeID) >::type; };
+
+		template< int32_t nodeID >
+		struct NodeCppType< nodeID, EnumNodeType::TypePointer > { using type = typename NodeCppType< StaticStructInfo::elementTypeID(nodeID) >::type*; };
+
+		template< int32_t nodeID >
+		struct NodeCppType< nodeID, EnumNodeType::TypeArray > {
+			using type = $A<
+				typename NodeCppType< StaticStructInfo::elementTypeID(nodeID) >::type,
+				StaticStructInfo::nodeSize(nodeID) / StaticStructInfo::nodeSize( StaticStructInfo::elementTypeID(nodeID) ) >;
+		};
+
+		template< int32_t nodeID >
+		struct NodeCppType< nodeID, EnumNodeType::TypeDataMemberField > { using type = typename NodeCppType< StaticStructInfo::elementTypeID(nodeID) >::type; };
+
+		template< int32_t nodeID >
+		struct NodeCppType< nodeID, EnumNodeType::TypeStaticDataMemberField > { using type = typename NodeCppType< StaticStructInfo::elementTypeID(nodeID) >::type; };
+
+		template< int32_t nodeID >
+		struct NodeCppType< nodeID, EnumNodeType::TypeVar > { using type = typename NodeCppType< StaticStructInfo::elementTypeID(nodeID) >::type; };
+
+		#if defined(__cpp_nontype_template_args) && ( __cpp_nontype_template_args >= 201911L )
+			template< size_t N >
+			struct StaticString {
+				char value[N] = {};
+
+				constexpr StaticString(const char (&str)[N]) {
+					for(size_t i = 0; i != N; i++)
+						value[i] = str[i];
+				}
+			};
+
+			template< StaticString structName, StaticString fieldPath >
+			constexpr uint32_t offsetOf() {
+				constexpr uint32_t offset = offsetOf(structName.value, fieldPath.value);
+				static_assert( offset != StaticStructInfo::InvalidOffset, "ATF::Reflect::offsetOf: field not found" );
+				return offset;
+			}
+
+			template< StaticString structName, StaticString fieldPath >
+			using fieldType = typename NodeCppType< fieldTypeID(structName.value, fieldPath.value) >::type;
+		#endif
+
+	}
+}
\ No newline at end of file
@@ -32,7 +32,7 @@ namespace ATF {
 			private:
 				std::unordered_map< int32_t, Node > _fakeNodeIdMap;
 					
-				int32_t _nextFakeID = 1 << 30;
+				int32_t _nextFakeID = FakeIDStart;
 				int32_t _getNextFakeID() {
 					return _nextFakeID++;
 				}
@@ -51,6 +51,9 @@ namespace ATF {
 				}
 
 			public:
+				static constexpr int32_t FakeIDStart = 1 << 30;
+				static bool isFakeID(const int32_t nodeID) { return nodeID >= FakeIDStart; }
+
 				Node getNode(const int32_t nodeID) const {
 					const auto it = _fakeNodeIdMap.find(nodeID);
 					if ( it != _fakeNodeIdMap.end() )
@@ -58,6 +61,13 @@ namespace ATF {
 
 					return ATF::Reflect::getStructNode(nodeID);
 				}
+				NodeView getNodeView(const int32_t nodeID) const {
+					const auto it = _fakeNodeIdMap.find(nodeID);
+					if ( it != _fakeNodeIdMap.end() )
+						return NodeView{ &it->second, nodeID };
+
+					return ATF::Reflect::getStructNodeView(nodeID);
+				}
 				
 				Node createNodePointer(const ATF::Reflect::Node& elementTypeNode) {
 					Node n;
@@ -86,140 +96,541 @@ namespace ATF {
 			bool        dumpJson    = true;
 			uint32_t    startGapLvl = 0;
 			const char* gap         = "  ";
+			bool        dumpMsgPack = false;		/// MessagePack instead of text, dumpJson/startGapLvl/gap are ignored
+
+			uint32_t    maxDepth         = 0;		/// Structs/arrays nested deeper are written as null, 0 - unlimited
+			uint32_t    maxArrayElements = 0;		/// Only the first elements of arrays (not char[]), 0 - unlimited
+			const char* fields           = nullptr;	/// Projection "m_Pos.*,m_dwHP": comma separated dot paths, '*'/'?' glob per part, arrays are transparent
+		};
+
+		/// Flat dump program for one root node and one set of options.
+		/// Every instruction writes text[textOffset, +textSize] (keys, brackets, gaps, quotes or MessagePack headers) and then one value read at pData + offset.
+		/// Arrays are one loop: the element instructions are compiled once for element 0 and run count times, so the plan does not grow with the count
+		struct DumpPlan : public ErrorList {
+			enum EnumOp : uint8_t {
+				OpText,
+				OpScalar,
+				OpBitfield,
+				OpCharArray,
+				OpPointer,
+				OpLoop,			/// Body up to the OpLoopEnd at index mask runs size times, offset is the stride added to the body offsets per element
+				OpLoopEnd,		/// Text is the element tail and the separator, only the first size bytes (the tail) follow the last element
+			};
+			struct TInstr {
+				EnumOp         eOp         = OpText;
+				EnumScalarKind eScalarKind = EnumScalarKind::None;
+				uint8_t        shift       = 0;
+				uint32_t       offset      = 0;
+				uint32_t       size        = 0;
+				uint64_t       mask        = 0;
+				uint32_t       textOffset  = 0;
+				uint32_t       textSize    = 0;
+			};
+
+			bool                  dumpJson    = true;
+			bool                  dumpMsgPack = false;
+			std::vector< TInstr > instrList;
+			std::string           text;
+
+			/// Bytes of the root object read by instructions, [dataBegin, dataEnd)
+			uint32_t              dataBegin   = 0;
+			uint32_t              dataEnd     = 0;
+
+			/// Diff plan (StructDumper::diffStruct): one instruction per leaf sorted by offset, its text is the leaf key (no loops, every element has its own key).
+			/// The last OpText closes the object
+			bool                  diff        = false;
+
+			/// Dumped TypePointer values: OpPointer instruction index and pointee type node, followed by StructDumper::dumpGraph
+			std::vector< std::pair< uint32_t, int32_t > > pointerList;
+
+			/// Bytes held by the plan, DumpPlanCache is bounded by their sum
+			size_t memorySize() const {
+				return sizeof(*this) + instrList.capacity() * sizeof(TInstr) + text.capacity() + pointerList.capacity() * sizeof(pointerList[0]);
+			}
+		};
+
+		/// One memory read of StructDumper::dumpGraph, the reader fills data (size is preset, may be 0) and sets ok
+		struct TGraphRead {
+			uint64_t               address = 0;
+			std::vector< uint8_t > data;
+			bool                   ok      = false;
+		};
+
+		/// StructDumper sink over a FILE*, buffering is left to stdio
+		class DumpFileSink {
+			private:
+				FILE* _pFile = nullptr;
+
+			public:
+				DumpFileSink(FILE* pFile) : _pFile(pFile) {}
+
+				void append(const char* pData, const size_t size) {
+					if ( size )
+						fwrite(pData, 1, size, _pFile);
+				}
+		};
+
+		/// StructDumper sink over a file descriptor, writes in bufferSize chunks
+		class DumpFdSink {
+			private:
+				int                 _fd   = -1;
+				bool                _fail = false;
+				std::vector< char > _buffer;
+				size_t              _used = 0;
+
+				void _writeAll(const char* pData, size_t size) {
+					while( size && !_fail ) {
+						#ifdef _WIN32
+							const auto n = ::_write(_fd, pData, static_cast< unsigned int >( size > 0x40000000 ? 0x40000000 : size ));
+						#else
+							const auto n = ::write(_fd, pData, size);
+						#endif
+						if ( n <= 0 ) {
+							_fail = true;
+							return;
+						}
+
+						pData += n;
+						size  -= n;
+					}
+				}
+
+			public:
+				DumpFdSink(const int fd, const size_t bufferSize = 64 * 1024) : _fd(fd), _buffer(bufferSize ? bufferSize : 1) {}
+				DumpFdSink(const DumpFdSink&) = delete;
+				DumpFdSink& operator=(const DumpFdSink&) = delete;
+				~DumpFdSink() {
+					flush();
+				}
+
+				void append(const char* pData, const size_t size) {
+					if ( _used + size > _buffer.size() ) {
+						flush();
+						if ( size >= _buffer.size() ) {
+							_writeAll(pData, size);
+							return;
+						}
+					}
+
+					memcpy(&_buffer[_used], pData, size);
+					_used += size;
+				}
+				bool flush() {
+					_writeAll(_buffer.data(), _used);
+					_used = 0;
+					return !_fail;
+				}
+				bool fail() const { return _fail; }
+		};
+
+		/// Plans of real (non fake) nodes and of fake arrays of real nodes (slices, by element id and count), shared by all StructDumper instances
+		class DumpPlanCache {
+			private:
+				using TKey = std::tuple< int32_t, bool, bool, size_t, std::string, uint32_t, uint32_t, std::string, bool, uint32_t >;
+
+				using TLruList = std::list< std::pair< TKey, std::shared_ptr< const DumpPlan > > >;
+
+				/// Projections and slice counts come from API clients, keep the cache bounded by bytes: least recently used plans are dropped
+				/// one by one, plans above MaxPlanSize are returned without being cached
+				static constexpr size_t MaxCacheSize = 64 << 20;
+				static constexpr size_t MaxPlanSize  = MaxCacheSize / 16;
+
+				std::mutex                             _mutex;
+				TLruList                               _lruList;
+				std::map< TKey, TLruList::iterator > _planMap;
+				size_t                                 _size = 0;
+
+				static size_t _entrySize(const TKey& key, const DumpPlan& plan) {
+					return sizeof(TLruList::value_type) + std::get< 4 >(key).capacity() + std::get< 7 >(key).capacity() + plan.memorySize();
+				}
+
+			public:
+				template< class TFun >
+				std::shared_ptr< const DumpPlan > get(const TKey& key, const TFun fCompile) {
+					{
+						std::lock_guard< std::mutex > lock(_mutex);
+						const auto it = _planMap.find(key);
+						if ( it != _planMap.end() ) {
+							_lruList.splice(_lruList.begin(), _lruList, it->second);
+							return it->second->second;
+						}
+					}
+
+					const std::shared_ptr< const DumpPlan > plan = fCompile();
+					const size_t planSize = _entrySize(key, *plan);
+					if ( planSize > MaxPlanSize )
+						return plan;
+
+					std::lock_guard< std::mutex > lock(_mutex);
+					const auto it = _planMap.find(key);
+					if ( it != _planMap.end() )
+						return it->second->second;
+
+					_lruList.emplace_front(key, plan);
+					_planMap[ key ] = _lruList.begin();
+					_size += planSize;
+					while( _size > MaxCacheSize ) {
+						_size -= _entrySize(_lruList.back().first, *_lruList.back().second);
+						_planMap.erase(_lruList.back().first);
+						_lruList.pop_back();
+					}
+
+					return plan;
+				}
+
+				static DumpPlanCache& global() {
+					static DumpPlanCache cache;
+					return cache;
+				}
 		};
 		class StructDumper : public ErrorList {
 			private:
 				bool        dumpJson    = true;
 				const char* gap         = "  ";
 				size_t      startGapLvl = 0;
+				bool        dumpMsgPack = false;
+
+				uint32_t    maxDepth         = 0;
+				uint32_t    maxArrayElements = 0;
+				std::string fieldProjection;
+
+				std::vector< std::vector< std::string > > _fieldPatternList;
 				
 				StructNodeExtends _nodeEx;
 				
-				template< const bool OnlyInt > static auto __dynamicDefineType();
-				template<> static auto __dynamicDefineType< true >() {
-					return [](const auto nodeName, const auto fNext) {
-						if ( nodeName == "int8_t"    ) fNext( (int8_t )0 );
-						if ( nodeName == "int16_t"   ) fNext( (int16_t)0 );
-						if ( nodeName == "int32_t"   ) fNext( (int32_t)0 );
-						if ( nodeName == "int64_t"   ) fNext( (int64_t)0 );
-
-						if ( nodeName == "uint8_t"   ) fNext( (uint8_t )0 );
-						if ( nodeName == "uint16_t"  ) fNext( (uint16_t)0 );
-						if ( nodeName == "uint32_t"  ) fNext( (uint32_t)0 );
-						if ( nodeName == "uint64_t"  ) fNext( (uint64_t)0 );
-					};
-				}
-				template<> static auto __dynamicDefineType< false >() {
-					using float32_t = ATF::float32_t;
-					using float64_t = ATF::float64_t;
-					using uchar16_t = ATF::uchar16_t;
-					
-					return [](const auto nodeName, const auto fNext) {
-						if ( nodeName == "bool"      ) fNext( (bool   )0 );
+				/// Kinds the dumper can print, bitfields accept integer kinds only
+				static std::string checkScalar(const ATF::Reflect::NodeView& node, const bool onlyInt) {
+					using namespace ATF::Reflect;
 
-						if ( nodeName == "float32_t" ) fNext( (float32_t)0 );
-						if ( nodeName == "float64_t" ) fNext( (float64_t)0 );
+					if ( node.type() != EnumNodeType::TypeScalar )
+						return stringFormat("Expected TypeScalar, got #", (int)node.type());
 
-						if ( nodeName == "char"      ) fNext( (int8_t   )0 );
-						if ( nodeName == "uchar16_t" ) fNext( (uchar16_t)0 );
+					const auto eScalarKind = node.scalarKind();
+					bool supported = false;
+					switch( eScalarKind ) {
+						case EnumScalarKind::Bool   :
+						case EnumScalarKind::Float32:
+						case EnumScalarKind::Float64:
+						case EnumScalarKind::Char   :
+						case EnumScalarKind::UChar16:
+							supported = !onlyInt;
+							break;
 
-						__dynamicDefineType< true >()(nodeName, fNext);
-					};
+						default:
+							supported = scalarKindIsInt(eScalarKind);
+							break;
+					}
+					if ( !supported )
+						return stringFormat("Invalid TypeScalar(", node.name(), ")");
+
+					if ( scalarKindSize(eScalarKind) != node.size() )
+						return stringFormat("Invalid TypeScalar(", node.name(),") size, expected ", node.size(), " got ", scalarKindSize(eScalarKind));
+
+					return "";
 				}
-				
-				template< const bool onlyInt, class TFun >
-				static std::string dynamicDefineType(const ATF::Reflect::Node& node, const TFun fNext) {
-					using namespace ATF::Reflect;
 
-					if ( node.eNodeType != EnumNodeType::TypeScalar )
-						return stringFormat("Expected TypeScalar, got #", (int)node.eNodeType);
+				static bool jsonNeedEscape(const uint8_t c) {
+					return ( c <= 31 ) || ( c == 34 ) || ( c == 92 ) || ( c >= 127 );
+				}
+				static uint32_t _lowestBit(const uint32_t mask) {
+					#ifdef _MSC_VER
+						unsigned long index = 0;
+						_BitScanForward(&index, mask);
+						return index;
+					#else
+						return __builtin_ctz(mask);
+					#endif
+				}
+				/// Escaped bytes become \u00xx, plain runs are appended in one piece. SSE2 checks 16 bytes per step
+				template< class TSink >
+				static void jsonAppendString(TSink& sink, const char* pStr, const size_t size) {
+					static const char hex[] = "0123456789abcdef";
 
-					std::string error = stringFormat("Invalid TypeScalar(",node.name,")");
-					
-					__dynamicDefineType< onlyInt >()(std::string(node.name), [&](const auto varType) {
-						if ( sizeof(varType) != node.size ) {
-							error = stringFormat("Invalid TypeScalar(", node.name,") size, expected ", node.size, " got ", sizeof(varType));
-							return;
+					size_t runStart = 0;
+					size_t i        = 0;
+					while( i < size ) {
+						#if defined(_M_X64) || defined(__SSE2__)
+							if ( i + 16 <= size ) {
+								const __m128i v    = _mm_loadu_si128( reinterpret_cast< const __m128i* >( pStr + i ) );
+								const __m128i ctrl = _mm_or_si128( _mm_cmplt_epi8(v, _mm_set1_epi8(32)), _mm_cmpeq_epi8(v, _mm_set1_epi8(127)) );
+								const __m128i quot = _mm_or_si128( _mm_cmpeq_epi8(v, _mm_set1_epi8(34)), _mm_cmpeq_epi8(v, _mm_set1_epi8(92)) );
+								const uint32_t mask = static_cast< uint32_t >( _mm_movemask_epi8( _mm_or_si128(ctrl, quot) ) );
+								if ( !mask ) {
+									i += 16;
+									continue;
+								}
+
+								i += _lowestBit(mask);
+							}
+						#endif
+
+						const uint8_t c = static_cast< uint8_t >( pStr[i] );
+						if ( !jsonNeedEscape(c) ) {
+							i++;
+							continue;
 						}
 
-						fNext(varType);
-						error = "";
-					});
-					
-						
-					return error;
-				}
-				
-				static std::string jsonChar(const uint8_t c) {
-					bool isEscape = false;
-					if ( c <= 31  ) isEscape = true;
-					if ( c == 34  ) isEscape = true;
-					if ( c == 92  ) isEscape = true;
-					if ( c >= 127 ) isEscape = true;
-					if ( c >= 127 ) isEscape = true;
-					
-					std::string str = "";
-					if ( isEscape ) {
-						std::stringstream sst;
-						sst << std::hex << ((uint32_t)c);
-						sst >> str;
-						while( str.length() < 4 )
-							str = "0" + str;
-						str = "\\u" + str;
-						return str;
+						sink.append(pStr + runStart, i - runStart);
+
+						const char escape[] = { '\\', 'u', '0', '0', hex[ c >> 4 ], hex[ c & 0xF ] };
+						sink.append(escape, sizeof(escape));
+
+						runStart = ++i;
 					}
-					
-					str += (char)c;
-					
-					return str;
-				}
-				static std::string jsonString(const std::string& in) {
-					std::string out = "";
-					for(const auto c : in)
-						out += jsonChar(c);
-					return out;
+
+					sink.append(pStr + runStart, size - runStart);
 				}
 				static std::string jsonQuotesCond(const std::string& in, const bool fl) {
 					return fl ? ( "\"" + in + "\"" ) : in;
 				}
-				static std::string jsonCorrectScalarValueCond(const std::string& in, const ATF::Reflect::Node& node, const bool fl) {
-					bool withoutCorrect = false;
-					auto add = [&](auto wc) {
-						if ( wc )
-							withoutCorrect = true;
-					};
-						
-					add(!fl);
-					add(!strcmp(node.name, "int32_t"  ));
-					add(!strcmp(node.name, "float32_t"));
-					add(!strcmp(node.name, "float64_t"));
-					add(node.size < 4);
-					
-					return jsonQuotesCond(in, !withoutCorrect);
+				static bool jsonScalarNeedQuotes(const EnumScalarKind eScalarKind, const uint32_t size, const bool fl) {
+					switch( eScalarKind ) {
+						case EnumScalarKind::Int32  :
+						case EnumScalarKind::Float32:
+						case EnumScalarKind::Float64:
+							return false;
+
+						default:
+							break;
+					}
+
+					return fl && ( size >= 4 );
+				}
+				static bool jsonScalarNeedQuotes(const ATF::Reflect::NodeView& node, const bool fl) {
+					return jsonScalarNeedQuotes(node.scalarKind(), node.size(), fl);
 				}
 
 
-				Node _getNode(const int32_t nodeID) {
-					const auto node = _nodeEx.getNode(nodeID);
-					if ( !node.valid )
-						errorAdd("Node #", nodeID, " not found");
+				NodeView _getNode(ErrorList& errorList, const int32_t nodeID) {
+					const auto node = _nodeEx.getNodeView(nodeID);
+					if ( !node.valid() )
+						errorList.errorAdd("Node #", nodeID, " not found");
 					
 					return node;
 				}
-			public:
-				StructDumper(const TStructDumperOptions& dumperOptions = {}, const StructNodeExtends& nodeEx = {}) : _nodeEx(nodeEx) {
-					dumpJson    = dumperOptions.dumpJson;
-					startGapLvl = dumperOptions.startGapLvl;
-					if ( dumperOptions.gap )
-						gap = dumperOptions.gap;
+
+				static uint32_t _instrDataSize(const DumpPlan::TInstr& instr) {
+					switch( instr.eOp ) {
+						case DumpPlan::OpScalar   :
+						case DumpPlan::OpBitfield : return scalarKindSize(instr.eScalarKind);
+						case DumpPlan::OpCharArray: return instr.size;
+						case DumpPlan::OpPointer  : return 8;
+						default:
+							break;
+					}
+					return 0;
 				}
-				
-				std::string dumpStruct(const ATF::Reflect::Node& node, const uint8_t* pData, size_t gapLv = 0) {
+				static void _emit(DumpPlan& plan, std::string& pending, DumpPlan::TInstr instr) {
+					instr.textOffset = static_cast< uint32_t >( plan.text.size() );
+					instr.textSize   = static_cast< uint32_t >( pending.size() );
+					plan.text += pending;
+					plan.instrList.push_back(instr);
+					pending.clear();
+
+					const uint32_t dataSize = _instrDataSize(instr);
+					if ( dataSize ) {
+						if ( !plan.dataEnd || ( instr.offset < plan.dataBegin ) )
+							plan.dataBegin = instr.offset;
+						if ( plan.dataEnd < instr.offset + dataSize )
+							plan.dataEnd = instr.offset + dataSize;
+					}
+				}
+
+				/// Open OpLoop and the data range of the plan before it, the body range is tracked from zero
+				struct TLoopOpen {
+					size_t   index     = 0;
+					uint32_t dataBegin = 0;
+					uint32_t dataEnd   = 0;
+				};
+				static TLoopOpen _emitLoop(DumpPlan& plan, std::string& pending, const uint32_t stride, const uint32_t count) {
+					DumpPlan::TInstr instr;
+					instr.eOp    = DumpPlan::OpLoop;
+					instr.offset = stride;
+					instr.size   = count;
+					_emit(plan, pending, instr);
+
+					TLoopOpen loop;
+					loop.index     = plan.instrList.size() - 1;
+					loop.dataBegin = plan.dataBegin;
+					loop.dataEnd   = plan.dataEnd;
+					plan.dataBegin = 0;
+					plan.dataEnd   = 0;
+					return loop;
+				}
+				/// pending holds the element tail, separator goes between elements. The body range is stretched over all elements
+				static void _emitLoopEnd(DumpPlan& plan, std::string& pending, const TLoopOpen& loop, const std::string& separator) {
+					plan.instrList[ loop.index ].mask = plan.instrList.size();
+
+					DumpPlan::TInstr instr;
+					instr.eOp  = DumpPlan::OpLoopEnd;
+					instr.size = static_cast< uint32_t >( pending.size() );
+					pending += separator;
+					_emit(plan, pending, instr);
+
+					if ( !plan.dataEnd ) {
+						plan.dataBegin = loop.dataBegin;
+						plan.dataEnd   = loop.dataEnd;
+						return;
+					}
+
+					const auto& loopInstr = plan.instrList[ loop.index ];
+					plan.dataEnd += loopInstr.offset * ( loopInstr.size - 1 );
+					if ( loop.dataEnd ) {
+						plan.dataBegin = std::min(plan.dataBegin, loop.dataBegin);
+						plan.dataEnd   = std::max(plan.dataEnd  , loop.dataEnd  );
+					}
+				}
+
+				static bool globMatch(const char* pPattern, const char* pText) {
+					const char* pStar     = nullptr;
+					const char* pStarText = nullptr;
+					while( *pText ) {
+						if ( ( *pPattern == '?' ) || ( ( *pPattern != '*' ) && ( *pPattern == *pText ) ) ) {
+							pPattern++;
+							pText++;
+							continue;
+						}
+						if ( *pPattern == '*' ) {
+							pStar     = pPattern++;
+							pStarText = pText;
+							continue;
+						}
+						if ( !pStar )
+							return false;
+
+						pPattern = pStar + 1;
+						pText    = ++pStarText;
+					}
+
+					while( *pPattern == '*' )
+						pPattern++;
+					return !*pPattern;
+				}
+
+				/// Projection state: (pattern, next part) pairs, empty selects the whole subtree
+				using TFieldSelect = std::vector< std::pair< size_t, size_t > >;
+				struct TSelectedField {
+					ATF::Reflect::NodeView fieldNode;
+					ATF::Reflect::NodeView fieldTypeNode;
+					TFieldSelect           select;
+				};
+
+				void _parseFieldProjection() {
+					_fieldPatternList.clear();
+
+					std::vector< std::string > partList;
+					std::string part;
+					const auto endPart = [&]() {
+						partList.push_back(part);
+						part.clear();
+					};
+					const auto endPattern = [&]() {
+						endPart();
+						if ( ( partList.size() > 1 ) || partList[0].length() )
+							_fieldPatternList.push_back(partList);
+						partList.clear();
+					};
+
+					for(const char c : fieldProjection) {
+						if ( c == ' ' ) continue;
+						if ( c == '.' ) { endPart   (); continue; }
+						if ( c == ',' ) { endPattern(); continue; }
+						part += c;
+					}
+					endPattern();
+				}
+				TFieldSelect _rootSelect() const {
+					TFieldSelect select;
+					for(size_t i = 0; i != _fieldPatternList.size(); i++)
+						select.push_back({ i, 0 });
+					return select;
+				}
+				/// Fields of a struct node passing the projection, each with the projection state of its subtree
+				std::vector< TSelectedField > _selectFields(DumpPlan& plan, const ATF::Reflect::NodeView& node, const TFieldSelect& select) {
+					std::vector< TSelectedField > selectedList;
+					for(const auto fieldNode : fields(node)) {
+						TSelectedField selected;
+						selected.fieldNode = fieldNode;
+
+						bool match = select.empty();
+						for(const auto& patternPart : select) {
+							const auto& partList = _fieldPatternList[ patternPart.first ];
+							if ( !globMatch(partList[ patternPart.second ].c_str(), fieldNode.name()) )
+								continue;
+
+							match = true;
+							if ( patternPart.second + 1 == partList.size() ) {
+								selected.select.clear();
+								break;
+							}
+
+							selected.select.push_back({ patternPart.first, patternPart.second + 1 });
+						}
+						if ( !match )
+							continue;
+
+						selected.fieldTypeNode = _getNode(plan, fieldNode.elementTypeID());
+						if ( !selected.fieldTypeNode.valid() )
+							continue;
+
+						selectedList.push_back(selected);
+					}
+					return selectedList;
+				}
+				bool _depthLimited(const uint32_t depth) const {
+					return maxDepth && ( depth >= maxDepth );
+				}
+				uint32_t _arrayCount(const ATF::Reflect::NodeView& node, const ATF::Reflect::NodeView& itemTypeNode) const {
+					const uint32_t count = itemTypeNode.size() ? ( node.size() / itemTypeNode.size() ) : 0;
+					return ( maxArrayElements && ( count > maxArrayElements ) ) ? maxArrayElements : count;
+				}
+
+				/// TypeScalar/TypeBitfield, false if the node can not be dumped (error added to the plan)
+				bool _valueInstr(DumpPlan& plan, const ATF::Reflect::NodeView& node, const uint32_t offset, DumpPlan::TInstr& instr, ATF::Reflect::NodeView& scalarNode) {
 					using namespace ATF::Reflect;
-					
-					if ( gapLv == 0 )
-						gapLv = startGapLvl;
-					
+
+					instr.offset = offset;
+
+					if ( node.type() == EnumNodeType::TypeScalar ) {
+						const auto error = checkScalar(node, false);
+						if ( error.length() ) {
+							plan.errorAdd(error);
+							return false;
+						}
+
+						instr.eOp         = DumpPlan::OpScalar;
+						instr.eScalarKind = node.scalarKind();
+						scalarNode        = node;
+						return true;
+					}
+
+					const auto nodeNext = _getNode(plan, node.elementTypeID());
+					if ( !nodeNext.valid() )
+						return false;
+
+					if ( nodeNext.type() != EnumNodeType::TypeScalar ) {
+						plan.errorAdd("Invald TypeBitfield");
+						return false;
+					}
+
+					const auto error = checkScalar(nodeNext, true);
+					if ( error.length() ) {
+						plan.errorAdd(error);
+						return false;
+					}
+
+					instr.eOp         = DumpPlan::OpBitfield;
+					instr.eScalarKind = nodeNext.scalarKind();
+					instr.shift       = static_cast< uint8_t >( node.startingPosition() );
+					instr.mask        = ( node.bits() >= 64 ) ? ~0ull : ( ( 1ull << node.bits() ) - 1 );
+					scalarNode        = nodeNext;
+					return true;
+				}
+
+				/// Walks the node once and appends instructions, layout must stay identical to the text/json format
+				void _compile(DumpPlan& plan, std::string& pending, const ATF::Reflect::NodeView& node, const uint32_t offset, const size_t gapLv, const uint32_t depth, const TFieldSelect& select) {
+					using namespace ATF::Reflect;
+
 					std::string GAP_PREV = "";
 					std::string GAP = "";
 					for(size_t i = 0; i != gapLv; i++) {
@@ -227,141 +638,960 @@ namespace ATF {
 						if ( i != 0 )
 							GAP_PREV += gap;
 					}
-					
-					const auto readCStr = [](const void* pData, const size_t size) {
-						std::vector< char > charList;
-						charList.resize( size + 1 );
-						memcpy(&charList[0], pData, size);
-						charList[size] = 0;
-						return std::string(&charList[0]);
-					};
 
-					switch( node.eNodeType ) {
+					switch( node.type() ) {
 						case EnumNodeType::TypeStruct:
 						case EnumNodeType::TypeClass:
 						case EnumNodeType::TypeUnion: {
-							std::string dump = "";
-							eachStructField(node, [&](const auto fieldNode) {
-								const auto fieldTypeNode = _getNode(fieldNode.typeDataMemberField.elementTypeID);
-								if ( !fieldTypeNode.valid )
-									return;
-								
-								if ( dump.length() )
-									dump +=  + ( dumpJson ? "," : "" );
-								
-								if ( dump.length() && dump[ dump.length() - 1 ] != '\n' )
-									dump += "\n";
-
-								dump += GAP + jsonQuotesCond(fieldNode.name, dumpJson) + ": ";
-								dump += dumpStruct(fieldTypeNode, pData + fieldNode.typeDataMemberField.offset, gapLv + 1);
-							});
-							dump = "{\n" + dump;
-							dump += "\n";
-							dump += GAP_PREV + "}";
-							
-							return dump;
+							if ( _depthLimited(depth) ) {
+								pending += "null";
+								return;
+							}
+
+							pending += "{\n";
+
+							bool first = true;
+							for(const auto& selected : _selectFields(plan, node, select)) {
+								if ( !first )
+									pending += dumpJson ? ",\n" : "\n";
+								first = false;
+
+								pending += GAP + jsonQuotesCond(selected.fieldNode.name(), dumpJson) + ": ";
+								_compile(plan, pending, selected.fieldTypeNode, offset + selected.fieldNode.offset(), gapLv + 1, depth + 1, selected.select);
+							}
+
+							pending += "\n" + GAP_PREV + "}";
+							return;
 						}
 						break;
-						
-						case EnumNodeType::TypeScalar: {
-							std::string valueStr = "";
-							
-							const auto nodeName = std::string(node.name);
-							const auto error = dynamicDefineType< false >(node, [&](const auto varType) {
-								const auto value = *reinterpret_cast< const decltype(varType)*  >( pData );
-								
-								valueStr = std::to_string(value);
-								
-								if ( nodeName == "bool" )
-									valueStr = value ? "true" : "false";
-							});
-							
-							if ( valueStr.length() )
-								return jsonCorrectScalarValueCond(valueStr, node, dumpJson);
-							
-							errorAdd(error);
-							return "";
+
+						case EnumNodeType::TypeScalar:
+						case EnumNodeType::TypeBitfield: {
+							DumpPlan::TInstr instr;
+							NodeView scalarNode;
+							if ( !_valueInstr(plan, node, offset, instr, scalarNode) )
+								return;
+
+							const auto quotes = jsonScalarNeedQuotes(scalarNode, dumpJson) ? "\"" : "";
+							pending += quotes;
+							_emit(plan, pending, instr);
+							pending += quotes;
+							return;
 						}
 						break;
-						
-						case EnumNodeType::TypeBitfield: {
-							const auto nodeNext = _getNode(node.typeBitfield.elementTypeID);
-							if ( !nodeNext.valid )
-								return "";
-							
-							if ( nodeNext.eNodeType != EnumNodeType::TypeScalar ) {
-								errorAdd("Invald TypeBitfield");
-								return "";
+
+						case EnumNodeType::TypeArray: {
+							const auto itemTypeNode = _getNode(plan, node.elementTypeID());
+							if ( !itemTypeNode.valid() )
+								return;
+
+							const bool isItemNodeScalar = itemTypeNode.type() == EnumNodeType::TypeScalar;
+
+							if ( itemTypeNode.scalarKind() == EnumScalarKind::Char ) {
+								DumpPlan::TInstr instr;
+								instr.eOp    = DumpPlan::OpCharArray;
+								instr.offset = offset;
+								instr.size   = node.size();
+
+								pending += "\"";
+								_emit(plan, pending, instr);
+								pending += "\"";
+								return;
 							}
-							
-							std::string valueStr;
-							const auto error = dynamicDefineType< true >(nodeNext, [&](const auto varType) {
-								const auto value = *reinterpret_cast< const decltype(varType)*  >( pData );
-								const auto bits = (value >> node.typeBitfield.startingPosition) & ( ( 1 << node.typeBitfield.bits ) - 1 );
-								valueStr = std::to_string(bits);
-							});
-							
-							if ( valueStr.length() )
-								return jsonCorrectScalarValueCond(valueStr, nodeNext, dumpJson);
-							
-							errorAdd(error);
-							return "";
+
+							if ( _depthLimited(depth) ) {
+								pending += "null";
+								return;
+							}
+
+							const uint32_t count = _arrayCount(node, itemTypeNode);
+							const std::string nl = isItemNodeScalar ? "" : "\n";
+
+							pending += "[" + nl;
+							if ( count ) {
+								if ( !isItemNodeScalar )
+									pending += GAP;
+
+								const auto loop = _emitLoop(plan, pending, static_cast< uint32_t >( itemTypeNode.size() ), count);
+								_compile(plan, pending, itemTypeNode, offset, gapLv + 1, depth + 1, select);
+								_emitLoopEnd(plan, pending, loop, ", " + nl + ( isItemNodeScalar ? "" : GAP ));
+
+								pending += nl;
+							}
+							pending += ( isItemNodeScalar ? "" : GAP_PREV ) + "]";
+							return;
 						}
 						break;
-						
+
+						case EnumNodeType::TypePointer: {
+							DumpPlan::TInstr instr;
+							instr.eOp    = DumpPlan::OpPointer;
+							instr.offset = offset;
+							_emit(plan, pending, instr);
+
+							plan.pointerList.push_back({ static_cast< uint32_t >( plan.instrList.size() - 1 ), node.elementTypeID() });
+							return;
+						}
+						break;
+
+						default:
+							break;
+					}
+
+					plan.errorAdd("Invalid type node '", (int)node.type(), "'");
+				}
+
+				/// MessagePack layout: struct -> map { field nameID: value }, array -> array, char[] -> str, scalars/pointers -> native width tagged values
+				void _compileMsgPack(DumpPlan& plan, std::string& pending, const ATF::Reflect::NodeView& node, const uint32_t offset, const uint32_t depth, const TFieldSelect& select) {
+					using namespace ATF::Reflect;
+
+					switch( node.type() ) {
+						case EnumNodeType::TypeStruct:
+						case EnumNodeType::TypeClass:
+						case EnumNodeType::TypeUnion: {
+							if ( _depthLimited(depth) ) {
+								pending += '\xC0';
+								return;
+							}
+
+							const auto selectedList = _selectFields(plan, node, select);
+							_msgPackHeader(pending, 0x80, 16, 0, 0xDE, 0xDF, static_cast< uint32_t >( selectedList.size() ));
+							for(const auto& selected : selectedList) {
+								_msgPackUInt(pending, static_cast< uint32_t >( selected.fieldNode.nameID() ));
+								_compileMsgPack(plan, pending, selected.fieldTypeNode, offset + selected.fieldNode.offset(), depth + 1, selected.select);
+							}
+							return;
+						}
+						break;
+
+						case EnumNodeType::TypeScalar:
+						case EnumNodeType::TypeBitfield: {
+							DumpPlan::TInstr instr;
+							NodeView scalarNode;
+							if ( _valueInstr(plan, node, offset, instr, scalarNode) )
+								_emit(plan, pending, instr);
+							return;
+						}
+						break;
+
 						case EnumNodeType::TypeArray: {
-							const auto itemTypeNode = _getNode(node.typeArray.elementTypeID);
-							if ( !itemTypeNode.valid )
-								return "";
-							
-							const size_t count = node.size / itemTypeNode.size;
-							
-							const bool isItemNodeScalar = itemTypeNode.eNodeType == EnumNodeType::TypeScalar;
-							
-							if ( isItemNodeScalar && !strcmp(itemTypeNode.name, "char") ) {
-								const auto bText = readCStr(pData, node.size);
-								return "\"" + ( dumpJson ? jsonString(bText) : bText ) + "\"";
+							const auto itemTypeNode = _getNode(plan, node.elementTypeID());
+							if ( !itemTypeNode.valid() )
+								return;
+
+							if ( itemTypeNode.scalarKind() == EnumScalarKind::Char ) {
+								DumpPlan::TInstr instr;
+								instr.eOp    = DumpPlan::OpCharArray;
+								instr.offset = offset;
+								instr.size   = node.size();
+								_emit(plan, pending, instr);
+								return;
 							}
-							
-							std::string dump = "[";
-							if ( !isItemNodeScalar )
-								dump += "\n";
-							for(size_t i = 0; i != count; i++) {
-								if ( !isItemNodeScalar )
-									dump += GAP;
-								
-								dump += dumpStruct(itemTypeNode, pData + itemTypeNode.size * i, gapLv + 1);
-								
-								if ( i + 1 != count )
-									dump += ", ";
-								
-								if ( !isItemNodeScalar )
-									dump += "\n";
+
+							if ( _depthLimited(depth) ) {
+								pending += '\xC0';
+								return;
 							}
-							dump += ( isItemNodeScalar ? "" : GAP_PREV ) + "]";
-							
-							return dump;
+
+							const uint32_t count = _arrayCount(node, itemTypeNode);
+							_msgPackHeader(pending, 0x90, 16, 0, 0xDC, 0xDD, count);
+							if ( count ) {
+								const auto loop = _emitLoop(plan, pending, static_cast< uint32_t >( itemTypeNode.size() ), count);
+								_compileMsgPack(plan, pending, itemTypeNode, offset, depth + 1, select);
+								_emitLoopEnd(plan, pending, loop, "");
+							}
+							return;
 						}
 						break;
-						
+
 						case EnumNodeType::TypePointer: {
-							return ptrToHex( *reinterpret_cast< const uint64_t* >( pData ), dumpJson );
+							DumpPlan::TInstr instr;
+							instr.eOp    = DumpPlan::OpPointer;
+							instr.offset = offset;
+							_emit(plan, pending, instr);
+
+							plan.pointerList.push_back({ static_cast< uint32_t >( plan.instrList.size() - 1 ), node.elementTypeID() });
+							return;
 						}
 						break;
+
+						default:
+							break;
+					}
+
+					plan.errorAdd("Invalid type node '", (int)node.type(), "'");
+				}
+
+				/// Leaves with their paths "m_Pos.x", "m_PosArr[1].y"; char[] and pointers are leaves, projection/limits as in _compile
+				void _compileDiff(DumpPlan& plan, std::vector< std::pair< std::string, DumpPlan::TInstr > >& leafList, const ATF::Reflect::NodeView& node, const uint32_t offset, const std::string& path, const uint32_t depth, const TFieldSelect& select) {
+					using namespace ATF::Reflect;
+
+					switch( node.type() ) {
+						case EnumNodeType::TypeStruct:
+						case EnumNodeType::TypeClass:
+						case EnumNodeType::TypeUnion: {
+							if ( _depthLimited(depth) )
+								return;
+
+							for(const auto& selected : _selectFields(plan, node, select)) {
+								const std::string fieldPath = path.length() ? ( path + "." + selected.fieldNode.name() ) : std::string(selected.fieldNode.name());
+								_compileDiff(plan, leafList, selected.fieldTypeNode, offset + selected.fieldNode.offset(), fieldPath, depth + 1, selected.select);
+							}
+							return;
+						}
+						break;
+
+						case EnumNodeType::TypeScalar:
+						case EnumNodeType::TypeBitfield: {
+							DumpPlan::TInstr instr;
+							NodeView scalarNode;
+							if ( _valueInstr(plan, node, offset, instr, scalarNode) )
+								leafList.push_back({ path, instr });
+							return;
+						}
+						break;
+
+						case EnumNodeType::TypeArray: {
+							const auto itemTypeNode = _getNode(plan, node.elementTypeID());
+							if ( !itemTypeNode.valid() )
+								return;
+
+							if ( itemTypeNode.scalarKind() == EnumScalarKind::Char ) {
+								DumpPlan::TInstr instr;
+								instr.eOp    = DumpPlan::OpCharArray;
+								instr.offset = offset;
+								instr.size   = node.size();
+								leafList.push_back({ path, instr });
+								return;
+							}
+
+							if ( _depthLimited(depth) )
+								return;
+
+							const uint32_t count = _arrayCount(node, itemTypeNode);
+							for(uint32_t i = 0; i != count; i++)
+								_compileDiff(plan, leafList, itemTypeNode, offset + itemTypeNode.size() * i, path + "[" + std::to_string(i) + "]", depth + 1, select);
+							return;
+						}
+						break;
+
+						case EnumNodeType::TypePointer: {
+							DumpPlan::TInstr instr;
+							instr.eOp    = DumpPlan::OpPointer;
+							instr.offset = offset;
+							leafList.push_back({ path, instr });
+							return;
+						}
+						break;
+
+						default:
+							break;
+					}
+
+					plan.errorAdd("Invalid type node '", (int)node.type(), "'");
+				}
+				void _compileDiffPlan(DumpPlan& plan, std::string& pending, const ATF::Reflect::NodeView& node) {
+					std::vector< std::pair< std::string, DumpPlan::TInstr > > leafList;
+					_compileDiff(plan, leafList, node, 0, "", 0, _rootSelect());
+
+					std::stable_sort(leafList.begin(), leafList.end(), [](const auto& l, const auto& r) {
+						return l.second.offset < r.second.offset;
+					});
+
+					std::string GAP_PREV = "";
+					std::string GAP = "";
+					for(size_t i = 0; i != startGapLvl; i++) {
+						GAP += gap;
+						if ( i != 0 )
+							GAP_PREV += gap;
+					}
+
+					for(const auto& leaf : leafList) {
+						if ( dumpMsgPack ) {
+							_msgPackHeader(pending, 0xA0, 32, 0xD9, 0xDA, 0xDB, static_cast< uint32_t >( leaf.first.length() ));
+							pending += leaf.first;
+						} else {
+							pending += GAP + jsonQuotesCond(leaf.first, dumpJson) + ": ";
+						}
+
+						_emit(plan, pending, leaf.second);
+					}
+
+					if ( !dumpMsgPack )
+						pending += "\n" + GAP_PREV + "}";
+				}
+
+				template< class T >
+				static T _read(const uint8_t* p) {
+					T value;
+					memcpy(&value, p, sizeof(T));
+					return value;
+				}
+				static uint64_t _readInt(const EnumScalarKind eScalarKind, const uint8_t* p) {
+					switch( eScalarKind ) {
+						case EnumScalarKind::Int8  : return static_cast< uint64_t >( _read< int8_t   >(p) );
+						case EnumScalarKind::Int16 : return static_cast< uint64_t >( _read< int16_t  >(p) );
+						case EnumScalarKind::Int32 : return static_cast< uint64_t >( _read< int32_t  >(p) );
+						case EnumScalarKind::Int64 : return static_cast< uint64_t >( _read< int64_t  >(p) );
+						case EnumScalarKind::UInt8 : return _read< uint8_t  >(p);
+						case EnumScalarKind::UInt16: return _read< uint16_t >(p);
+						case EnumScalarKind::UInt32: return _read< uint32_t >(p);
+						case EnumScalarKind::UInt64: return _read< uint64_t >(p);
+						default:
+							break;
+					}
+					return 0;
+				}
+				/// Writes backwards, returns the first char
+				static char* _formatU64(char* pEnd, uint64_t value) {
+					static const char digitPairs[] =
+						"00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+					while( value >= 100 ) {
+						const auto i = static_cast< size_t >( value % 100 ) * 2;
+						value /= 100;
+						*--pEnd = digitPairs[ i + 1 ];
+						*--pEnd = digitPairs[ i     ];
+					}
+					if ( value >= 10 ) {
+						const auto i = static_cast< size_t >( value ) * 2;
+						*--pEnd = digitPairs[ i + 1 ];
+						*--pEnd = digitPairs[ i     ];
+					} else {
+						*--pEnd = static_cast< char >( '0' + value );
+					}
+					return pEnd;
+				}
+				static char* _formatPtr(char* pEnd, uint64_t value) {
+					static const char hex[] = "0123456789ABCDEF";
+					for(size_t i = 0; i != 16; i++, value >>= 4)
+						*--pEnd = hex[ value & 0xF ];
+					return pEnd;
+				}
+
+				template< class TSink >
+				static void _appendU64(TSink& sink, const uint64_t value) {
+					char buffer[24];
+					char* const pEnd = buffer + sizeof(buffer);
+					const char* pBegin = _formatU64(pEnd, value);
+					sink.append(pBegin, pEnd - pBegin);
+				}
+				template< class TSink >
+				static void _appendI64(TSink& sink, const int64_t value) {
+					char buffer[24];
+					char* const pEnd = buffer + sizeof(buffer);
+					char* pBegin = _formatU64(pEnd, ( value < 0 ) ? ( 0 - static_cast< uint64_t >( value ) ) : static_cast< uint64_t >( value ));
+					if ( value < 0 )
+						*--pBegin = '-';
+					sink.append(pBegin, pEnd - pBegin);
+				}
+				/// Same text as std::to_string ("%f")
+				template< class TSink >
+				static void _appendF64(TSink& sink, const double value) {
+					char buffer[512];
+					#if defined(__cpp_lib_to_chars) && ( __cpp_lib_to_chars >= 201611L )
+						const auto res = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 6);
+						sink.append(buffer, res.ptr - buffer);
+					#else
+						const int length = snprintf(buffer, sizeof(buffer), "%f", value);
+						if ( length > 0 )
+							sink.append(buffer, ( static_cast< size_t >( length ) < sizeof(buffer) ) ? length : ( sizeof(buffer) - 1 ));
+					#endif
+				}
+				template< class TSink >
+				static void _appendPtr(TSink& sink, const uint64_t value, const bool dumpJson) {
+					char buffer[24];
+					char* const pEnd = dumpJson ? ( buffer + sizeof(buffer) - 1 ) : ( buffer + sizeof(buffer) );
+					char* pBegin = _formatPtr(pEnd, value);
+					*--pBegin = 'x';
+					*--pBegin = '0';
+					if ( dumpJson ) {
+						*--pBegin = '"';
+						*pEnd     = '"';
+					}
+					sink.append(pBegin, ( buffer + sizeof(buffer) ) - pBegin);
+				}
+
+				/// MessagePack tag followed by size bytes of value, big-endian
+				template< class TSink >
+				static void _msgPackAppend(TSink& sink, const uint8_t tag, const uint64_t value, const size_t size) {
+					char buffer[9];
+					buffer[0] = static_cast< char >( tag );
+					for(size_t i = 0; i != size; i++)
+						buffer[ 1 + i ] = static_cast< char >( value >> ( ( size - 1 - i ) * 8 ) );
+					sink.append(buffer, 1 + size);
+				}
+				template< class TSink >
+				static void _msgPackHeader(TSink& sink, const uint8_t fixTag, const uint32_t fixCount, const uint8_t tag8, const uint8_t tag16, const uint8_t tag32, const uint32_t count) {
+					if ( count < fixCount ) {
+						const char c = static_cast< char >( fixTag | count );
+						sink.append(&c, 1);
+						return;
+					}
+
+					if ( tag8 && ( count <= 0xFF ) )
+						_msgPackAppend(sink, tag8, count, 1);
+					else if ( count <= 0xFFFF )
+						_msgPackAppend(sink, tag16, count, 2);
+					else
+						_msgPackAppend(sink, tag32, count, 4);
+				}
+				static void _msgPackUInt(std::string& out, const uint64_t value) {
+					if ( value < 0x80 )
+						out += static_cast< char >( value );
+					else if ( value <= 0xFF )
+						_msgPackAppend(out, 0xCC, value, 1);
+					else if ( value <= 0xFFFF )
+						_msgPackAppend(out, 0xCD, value, 2);
+					else if ( value <= 0xFFFFFFFF )
+						_msgPackAppend(out, 0xCE, value, 4);
+					else
+						_msgPackAppend(out, 0xCF, value, 8);
+				}
+				template< class TSink >
+				static void _appendMsgPackScalar(TSink& out, const EnumScalarKind eScalarKind, const uint8_t* p) {
+					switch( eScalarKind ) {
+						case EnumScalarKind::Bool   : {
+							const char c = _read< uint8_t >(p) ? '\xC3' : '\xC2';
+							out.append(&c, 1);
+						}
+						break;
+
+						case EnumScalarKind::Int8   :
+						case EnumScalarKind::Char   : _msgPackAppend(out, 0xD0, _read< uint8_t  >(p), 1); break;
+						case EnumScalarKind::Int16  : _msgPackAppend(out, 0xD1, _read< uint16_t >(p), 2); break;
+						case EnumScalarKind::Int32  : _msgPackAppend(out, 0xD2, _read< uint32_t >(p), 4); break;
+						case EnumScalarKind::Int64  : _msgPackAppend(out, 0xD3, _read< uint64_t >(p), 8); break;
+						case EnumScalarKind::UInt8  : _msgPackAppend(out, 0xCC, _read< uint8_t  >(p), 1); break;
+						case EnumScalarKind::UInt16 :
+						case EnumScalarKind::UChar16: _msgPackAppend(out, 0xCD, _read< uint16_t >(p), 2); break;
+						case EnumScalarKind::UInt32 : _msgPackAppend(out, 0xCE, _read< uint32_t >(p), 4); break;
+						case EnumScalarKind::UInt64 : _msgPackAppend(out, 0xCF, _read< uint64_t >(p), 8); break;
+						case EnumScalarKind::Float32: _msgPackAppend(out, 0xCA, _read< uint32_t >(p), 4); break;
+						case EnumScalarKind::Float64: _msgPackAppend(out, 0xCB, _read< uint64_t >(p), 8); break;
+						default:
+							break;
+					}
+				}
+
+				template< class TSink >
+				static void _appendScalar(TSink& out, const EnumScalarKind eScalarKind, const uint8_t* p) {
+					switch( eScalarKind ) {
+						case EnumScalarKind::Bool   :
+							if ( _read< uint8_t >(p) )
+								out.append("true", 4);
+							else
+								out.append("false", 5);
+							break;
+
+						case EnumScalarKind::Int8   :
+						case EnumScalarKind::Char   : _appendI64(out, _read< int8_t   >(p)); break;
+						case EnumScalarKind::Int16  : _appendI64(out, _read< int16_t  >(p)); break;
+						case EnumScalarKind::Int32  : _appendI64(out, _read< int32_t  >(p)); break;
+						case EnumScalarKind::Int64  : _appendI64(out, _read< int64_t  >(p)); break;
+						case EnumScalarKind::UInt8  : _appendU64(out, _read< uint8_t  >(p)); break;
+						case EnumScalarKind::UInt16 :
+						case EnumScalarKind::UChar16: _appendU64(out, _read< uint16_t >(p)); break;
+						case EnumScalarKind::UInt32 : _appendU64(out, _read< uint32_t >(p)); break;
+						case EnumScalarKind::UInt64 : _appendU64(out, _read< uint64_t >(p)); break;
+						case EnumScalarKind::Float32: _appendF64(out, _read< float    >(p)); break;
+						case EnumScalarKind::Float64: _appendF64(out, _read< double   >(p)); break;
+						default:
+							break;
+					}
+				}
+
+			public:
+				StructDumper(const TStructDumperOptions& dumperOptions = {}, const StructNodeExtends& nodeEx = {}) : _nodeEx(nodeEx) {
+					dumpJson    = dumperOptions.dumpJson;
+					startGapLvl = dumperOptions.startGapLvl;
+					dumpMsgPack = dumperOptions.dumpMsgPack;
+					if ( dumperOptions.gap )
+						gap = dumperOptions.gap;
+
+					maxDepth         = dumperOptions.maxDepth;
+					maxArrayElements = dumperOptions.maxArrayElements;
+					if ( dumperOptions.fields )
+						fieldProjection = dumperOptions.fields;
+					_parseFieldProjection();
+				}
+				
+				std::shared_ptr< const DumpPlan > compilePlan(const ATF::Reflect::NodeView& node, const bool diff = false) {
+					auto plan = std::make_shared< DumpPlan >();
+					plan->dumpJson = dumpJson;
+
+					plan->dumpMsgPack = dumpMsgPack;
+					plan->diff        = diff;
+
+					std::string pending;
+					if ( diff )
+						_compileDiffPlan(*plan, pending, node);
+					else if ( dumpMsgPack )
+						_compileMsgPack(*plan, pending, node, 0, 0, _rootSelect());
+					else
+						_compile(*plan, pending, node, 0, startGapLvl, 0, _rootSelect());
+
+					DumpPlan::TInstr instr;
+					instr.eOp = DumpPlan::OpText;
+					_emit(*plan, pending, instr);
+
+					return plan;
+				}
+				/// Cached for real nodes and fake arrays of a real element type, other fake nodes of StructNodeExtends are compiled on every call
+				std::shared_ptr< const DumpPlan > getPlan(const ATF::Reflect::NodeView& node, const bool diff = false) {
+					if ( !node.valid() )
+						return compilePlan(node, diff);
+
+					int32_t  keyID      = node.id();
+					uint32_t arrayCount = 0;
+					if ( StructNodeExtends::isFakeID(keyID) ) {
+						const auto itemTypeNode = _nodeEx.getNodeView(node.elementTypeID());
+						if ( ( node.type() != EnumNodeType::TypeArray ) || !itemTypeNode.valid() || !itemTypeNode.size() || StructNodeExtends::isFakeID(itemTypeNode.id()) )
+							return compilePlan(node, diff);
+
+						keyID      = itemTypeNode.id();
+						arrayCount = node.size() / itemTypeNode.size() + 1;
+					}
+
+					return DumpPlanCache::global().get(std::make_tuple(keyID, dumpJson, dumpMsgPack, startGapLvl, std::string(gap), maxDepth, maxArrayElements, fieldProjection, diff, arrayCount), [&]() {
+						return compilePlan(node, diff);
+					});
+				}
+
+				/// TSink is anything with append(const char*, size_t): std::string, DumpFileSink, DumpFdSink.
+				/// pData points to byte dataOffset of the root object, e.g. a buffer holding only [plan.dataBegin, plan.dataEnd)
+				template< class TSink >
+				static void runPlan(const DumpPlan& plan, const uint8_t* pData, TSink& out, const uint32_t dataOffset = 0) {
+					if ( plan.dumpMsgPack ) {
+						_runMsgPackPlan(plan, pData, out, dataOffset);
+						return;
+					}
+
+					const auto fValue = [&](const DumpPlan::TInstr& instr, const uint32_t offset) {
+						_appendValue(out, instr, pData + ( static_cast< ptrdiff_t >( offset ) - dataOffset ), plan.dumpJson);
+					};
+					_runInstrRange(plan, 0, plan.instrList.size(), 0, out, fValue);
+				}
+
+				/// Runs instrList[first, last): the text of every instruction to out, then fValue(instr, offset) with the instruction offset moved by shift.
+				/// OpLoop runs its body count times, the stride is added to shift per element
+				template< class TSink, class TValueFun >
+				static void _runInstrRange(const DumpPlan& plan, const size_t first, const size_t last, const uint32_t shift, TSink& out, const TValueFun& fValue) {
+					for(size_t i = first; i < last; i++) {
+						const auto& instr = plan.instrList[i];
+						out.append(plan.text.data() + instr.textOffset, instr.textSize);
+						if ( instr.eOp != DumpPlan::OpLoop ) {
+							fValue(instr, shift + instr.offset);
+							continue;
+						}
+
+						const size_t loopEnd = static_cast< size_t >( instr.mask );
+						const auto& endInstr = plan.instrList[ loopEnd ];
+						for(uint32_t k = 0; k != instr.size; k++) {
+							_runInstrRange(plan, i + 1, loopEnd, shift + instr.offset * k, out, fValue);
+							out.append(plan.text.data() + endInstr.textOffset, ( k + 1 != instr.size ) ? endInstr.textSize : endInstr.size);
+						}
+						i = loopEnd;
+					}
+				}
+				/// Sink of _runInstrRange when only the values are wanted
+				struct TNullSink {
+					void append(const char*, const size_t) {}
+				};
+
+				static uint32_t _charArrayLength(const uint8_t* p, const uint32_t size) {
+					const auto pEnd = reinterpret_cast< const uint8_t* >( memchr(p, 0, size) );
+					return pEnd ? static_cast< uint32_t >( pEnd - p ) : size;
+				}
+				template< class TSink >
+				static void _appendValue(TSink& out, const DumpPlan::TInstr& instr, const uint8_t* p, const bool dumpJson) {
+					switch( instr.eOp ) {
+						case DumpPlan::OpText:
+						case DumpPlan::OpLoop:
+						case DumpPlan::OpLoopEnd:
+							break;
+
+						case DumpPlan::OpScalar:
+							_appendScalar(out, instr.eScalarKind, p);
+							break;
+
+						case DumpPlan::OpBitfield:
+							_appendU64(out, ( _readInt(instr.eScalarKind, p) >> instr.shift ) & instr.mask);
+							break;
+
+						case DumpPlan::OpCharArray: {
+							const size_t length = _charArrayLength(p, instr.size);
+							if ( dumpJson )
+								jsonAppendString(out, reinterpret_cast< const char* >( p ), length);
+							else
+								out.append(reinterpret_cast< const char* >( p ), length);
+						}
+						break;
+
+						case DumpPlan::OpPointer:
+							_appendPtr(out, _read< uint64_t >(p), dumpJson);
+							break;
 					}
-					
-					errorAdd("Invalid type node '", (int)node.eNodeType, "'");
-					return "";
+				}
+
+				template< class TSink >
+				static void _runMsgPackPlan(const DumpPlan& plan, const uint8_t* pData, TSink& out, const uint32_t dataOffset) {
+					const auto fValue = [&](const DumpPlan::TInstr& instr, const uint32_t offset) {
+						_appendMsgPackValue(out, instr, pData + ( static_cast< ptrdiff_t >( offset ) - dataOffset ));
+					};
+					_runInstrRange(plan, 0, plan.instrList.size(), 0, out, fValue);
+				}
+
+				template< class TSink >
+				static void _appendMsgPackValue(TSink& out, const DumpPlan::TInstr& instr, const uint8_t* p) {
+					static const uint8_t uintTag[] = { 0, 0xCC, 0xCD, 0, 0xCE, 0, 0, 0, 0xCF };
+
+					switch( instr.eOp ) {
+						case DumpPlan::OpText:
+						case DumpPlan::OpLoop:
+						case DumpPlan::OpLoopEnd:
+							break;
+
+						case DumpPlan::OpScalar:
+							_appendMsgPackScalar(out, instr.eScalarKind, p);
+							break;
+
+						case DumpPlan::OpBitfield: {
+							const auto size = scalarKindSize(instr.eScalarKind);
+							_msgPackAppend(out, uintTag[ size ], ( _readInt(instr.eScalarKind, p) >> instr.shift ) & instr.mask, size);
+						}
+						break;
+
+						case DumpPlan::OpCharArray: {
+							const uint32_t length = _charArrayLength(p, instr.size);
+							_msgPackHeader(out, 0xA0, 32, 0xD9, 0xDA, 0xDB, length);
+							out.append(reinterpret_cast< const char* >( p ), length);
+						}
+						break;
+
+						case DumpPlan::OpPointer:
+							_msgPackAppend(out, 0xCF, _read< uint64_t >(p), 8);
+							break;
+					}
+				}
+
+				/// First offset in [pos, end) where the snapshots differ, end if none. SSE2 compares 16 bytes per step
+				static uint32_t _findDiff(const uint8_t* pOld, const uint8_t* pNew, uint32_t pos, const uint32_t end) {
+					#if defined(_M_X64) || defined(__SSE2__)
+						for(; pos + 16 <= end; pos += 16) {
+							const __m128i vOld = _mm_loadu_si128( reinterpret_cast< const __m128i* >( pOld + pos ) );
+							const __m128i vNew = _mm_loadu_si128( reinterpret_cast< const __m128i* >( pNew + pos ) );
+							const uint32_t mask = static_cast< uint32_t >( _mm_movemask_epi8( _mm_cmpeq_epi8(vOld, vNew) ) ) ^ 0xFFFF;
+							if ( mask )
+								return pos + _lowestBit(mask);
+						}
+					#endif
+
+					for(; pos + 8 <= end; pos += 8)
+						if ( _read< uint64_t >(pOld + pos) != _read< uint64_t >(pNew + pos) )
+							break;
+
+					for(; pos < end; pos++)
+						if ( pOld[ pos ] != pNew[ pos ] )
+							return pos;
+
+					return end;
+				}
+				/// Leaves of a diff plan whose value changed. Leaves are sorted by offset, so the next differing byte is searched
+				/// once per unchanged block instead of once per leaf; only bitfields and char[] (bytes after the terminator) need a value compare
+				static void _diffLeaves(const DumpPlan& plan, const uint8_t* pOld, const uint8_t* pNew, std::vector< uint32_t >& changedList) {
+					uint32_t diffPos = _findDiff(pOld, pNew, plan.dataBegin, plan.dataEnd);
+					for(uint32_t i = 0; ( i < plan.instrList.size() ) && ( diffPos < plan.dataEnd ); i++) {
+						const auto& instr = plan.instrList[i];
+						if ( instr.eOp == DumpPlan::OpText )
+							continue;
+
+						if ( instr.offset > diffPos )
+							diffPos = _findDiff(pOld, pNew, instr.offset, plan.dataEnd);
+
+						if ( instr.offset + _instrDataSize(instr) <= diffPos )
+							continue;
+
+						if ( instr.eOp == DumpPlan::OpBitfield ) {
+							const uint64_t oldValue = ( _readInt(instr.eScalarKind, pOld + instr.offset) >> instr.shift ) & instr.mask;
+							const uint64_t newValue = ( _readInt(instr.eScalarKind, pNew + instr.offset) >> instr.shift ) & instr.mask;
+							if ( oldValue == newValue )
+								continue;
+						}
+
+						if ( instr.eOp == DumpPlan::OpCharArray ) {
+							const uint32_t length = _charArrayLength(pOld + instr.offset, instr.size);
+							if ( ( length == _charArrayLength(pNew + instr.offset, instr.size) ) && !memcmp(pOld + instr.offset, pNew + instr.offset, length) )
+								continue;
+						}
+
+						changedList.push_back(i);
+					}
+				}
+				template< class TSink >
+				static size_t _runDiffPlan(const DumpPlan& plan, const uint8_t* pOld, const uint8_t* pNew, TSink& out) {
+					std::vector< uint32_t > changedList;
+					_diffLeaves(plan, pOld, pNew, changedList);
+
+					if ( plan.dumpMsgPack ) {
+						_msgPackHeader(out, 0x80, 16, 0, 0xDE, 0xDF, static_cast< uint32_t >( changedList.size() ));
+						for(const auto i : changedList) {
+							const auto& instr = plan.instrList[i];
+							out.append(plan.text.data() + instr.textOffset, instr.textSize);
+							_appendMsgPackValue(out, instr, pNew + instr.offset);
+						}
+						return changedList.size();
+					}
+
+					out.append("{", 1);
+					for(const auto i : changedList) {
+						const auto& instr = plan.instrList[i];
+						if ( i == changedList[0] )
+							out.append("\n", 1);
+						else if ( plan.dumpJson )
+							out.append(",\n", 2);
+						else
+							out.append("\n", 1);
+
+						out.append(plan.text.data() + instr.textOffset, instr.textSize);
+
+						const bool quotes =
+							( instr.eOp == DumpPlan::OpCharArray ) ||
+							( ( ( instr.eOp == DumpPlan::OpScalar ) || ( instr.eOp == DumpPlan::OpBitfield ) ) &&
+								jsonScalarNeedQuotes(instr.eScalarKind, scalarKindSize(instr.eScalarKind), plan.dumpJson) );
+						if ( quotes )
+							out.append("\"", 1);
+						_appendValue(out, instr, pNew + instr.offset, plan.dumpJson);
+						if ( quotes )
+							out.append("\"", 1);
+					}
+
+					const auto& closeInstr = plan.instrList.back();
+					if ( changedList.size() )
+						out.append(plan.text.data() + closeInstr.textOffset, closeInstr.textSize);
+					else
+						out.append("}", 1);
+
+					return changedList.size();
+				}
+
+				/// gapLv != 0 overrides startGapLvl for this dump
+				std::string dumpStruct(const ATF::Reflect::Node& node, const uint8_t* pData, const size_t gapLv = 0) {
+					const size_t prevGapLvl = startGapLvl;
+					if ( gapLv )
+						startGapLvl = gapLv;
+
+					const auto dump = dumpStruct(getStructNodeView(node), pData);
+					startGapLvl = prevGapLvl;
+					return dump;
+				}
+				std::string dumpStruct(const ATF::Reflect::NodeView& node, const uint8_t* pData) {
+					std::string dump;
+					dumpStruct(node, pData, dump);
+					return dump;
+				}
+				template< class TSink, class = typename std::enable_if< !std::is_arithmetic< TSink >::value >::type >
+				void dumpStruct(const ATF::Reflect::Node& node, const uint8_t* pData, TSink& sink) {
+					dumpStruct(getStructNodeView(node), pData, sink);
+				}
+				/// Appends to sink, reuse one std::string (clear() keeps capacity) to dump without allocations
+				template< class TSink >
+				void dumpStruct(const ATF::Reflect::NodeView& node, const uint8_t* pData, TSink& sink) {
+					const auto plan = getPlan(node);
+					if ( plan->errorHas() )
+						for(const auto& error : plan->errorGetList())
+							errorAdd(error);
+
+					runPlan(*plan, pData, sink);
+				}
+
+
+				/// Object graph from address: { "0x<address>": object, ... } (MessagePack: map of uint64 address -> value).
+				/// Pointers of dumped objects are followed up to maxPointerDepth hops, every address is dumped once.
+				/// fReadMemory(std::vector< TGraphRead >&) is called once per depth level with all reads of that level.
+				/// Returns the number of objects
+				template< class TReadFun, class TSink >
+				size_t dumpGraph(const ATF::Reflect::NodeView& node, const uint64_t address, TReadFun fReadMemory, TSink& sink, const uint32_t maxPointerDepth, const size_t maxObjects = 4096) {
+					StructDumper objectDumper(*this);
+					objectDumper.startGapLvl++;
+
+					std::string GAP_PREV = "";
+					std::string GAP = "";
+					for(size_t i = 0; i != startGapLvl; i++) {
+						GAP += gap;
+						if ( i != 0 )
+							GAP_PREV += gap;
+					}
+
+					std::vector< TGraphRead > readList;
+					std::vector< std::shared_ptr< const DumpPlan > > planList;
+					std::unordered_set< uint64_t > visitedSet;
+					const auto addObject = [&](const uint64_t objectAddress, const ATF::Reflect::NodeView& objectNode) {
+						const auto plan = objectDumper.getPlan(objectNode);
+						if ( plan->errorHas() )
+							for(const auto& error : plan->errorGetList())
+								errorAdd(error);
+
+						TGraphRead read;
+						read.address = objectAddress + plan->dataBegin;
+						read.data.resize(plan->dataEnd - plan->dataBegin);
+
+						visitedSet.insert(objectAddress);
+						readList.push_back(std::move(read));
+						planList.push_back(plan);
+					};
+					addObject(address, node);
+
+					/// MessagePack map size is known at the end
+					std::string body;
+					size_t count = 0;
+					for(uint32_t depth = 0; readList.size(); depth++) {
+						fReadMemory(readList);
+
+						auto levelReadList = std::move(readList);
+						auto levelPlanList = std::move(planList);
+						readList.clear();
+						planList.clear();
+
+						for(size_t i = 0; i != levelReadList.size(); i++) {
+							const auto& read = levelReadList[i];
+							const auto& plan = *levelPlanList[i];
+							const uint64_t objectAddress = read.address - plan.dataBegin;
+							const uint8_t* pData = read.data.data();
+
+							if ( dumpMsgPack ) {
+								_msgPackAppend(body, 0xCF, objectAddress, 8);
+								if ( read.ok )
+									runPlan(plan, pData, body, plan.dataBegin);
+								else
+									body += '\xC0';
+							} else {
+								if ( !count )
+									sink.append("{\n", 2);
+								else if ( dumpJson )
+									sink.append(",\n", 2);
+								else
+									sink.append("\n", 1);
+
+								sink.append(GAP.data(), GAP.length());
+								_appendPtr(sink, objectAddress, dumpJson);
+								sink.append(": ", 2);
+								if ( read.ok )
+									runPlan(plan, pData, sink, plan.dataBegin);
+								else
+									sink.append("null", 4);
+							}
+							count++;
+
+							if ( !read.ok || ( depth >= maxPointerDepth ) )
+								continue;
+
+							if ( !plan.pointerList.size() )
+								continue;
+
+							/// Pointers in dump order, those of array elements once per element
+							TNullSink noText;
+							const auto fPointer = [&](const DumpPlan::TInstr& instr, const uint32_t offset) {
+								if ( instr.eOp != DumpPlan::OpPointer )
+									return;
+
+								const uint64_t pointerValue = _read< uint64_t >(pData + ( offset - plan.dataBegin ));
+								if ( !pointerValue || visitedSet.count(pointerValue) || ( visitedSet.size() >= maxObjects ) )
+									return;
+
+								const uint32_t index = static_cast< uint32_t >( &instr - plan.instrList.data() );
+								const auto it = std::lower_bound(plan.pointerList.begin(), plan.pointerList.end(), index, [](const std::pair< uint32_t, int32_t >& pointer, const uint32_t value) {
+									return pointer.first < value;
+								});
+								if ( ( it == plan.pointerList.end() ) || ( it->first != index ) )
+									return;
+
+								const auto pointeeNode = _nodeEx.getNodeView(it->second);
+								if ( !pointeeNode.valid() || !pointeeNode.size() || ( pointeeNode.type() == ATF::Reflect::EnumNodeType::TypeVoid ) )
+									return;
+
+								addObject(pointerValue, pointeeNode);
+							};
+							_runInstrRange(plan, 0, plan.instrList.size(), 0, noText, fPointer);
+						}
+					}
+
+					if ( dumpMsgPack ) {
+						_msgPackHeader(sink, 0x80, 16, 0, 0xDE, 0xDF, static_cast< uint32_t >( count ));
+						sink.append(body.data(), body.length());
+					} else {
+						const std::string close = "\n" + GAP_PREV + "}";
+						sink.append(close.data(), close.length());
+					}
+
+					return count;
+				}
+
+				/// Changed leaves only: { "m_Pos.x": new value, ... } (MessagePack: map of path -> value), both snapshots hold the whole node
+				std::string diffStruct(const ATF::Reflect::NodeView& node, const uint8_t* pOld, const uint8_t* pNew) {
+					std::string diff;
+					diffStruct(node, pOld, pNew, diff);
+					return diff;
+				}
+				/// Returns the number of changed leaves
+				template< class TSink >
+				size_t diffStruct(const ATF::Reflect::NodeView& node, const uint8_t* pOld, const uint8_t* pNew, TSink& sink) {
+					const auto plan = getPlan(node, true);
+					if ( plan->errorHas() )
+						for(const auto& error : plan->errorGetList())
+							errorAdd(error);
+
+					return _runDiffPlan(*plan, pOld, pNew, sink);
 				}
 
 
 				static std::string ptrToHex(const uint64_t ptr, const bool dumpJson = false) {
-					std::string ret = "";
-					std::stringstream sst;
-						
-					sst << (void*)ptr;
-					sst >> ret;
-					return jsonQuotesCond("0x" + ret, dumpJson);
+					std::string ret;
+					_appendPtr(ret, ptr, dumpJson);
+					return ret;
+				}
+				static std::string ptrToMsgPack(const uint64_t ptr) {
+					std::string ret;
+					_msgPackAppend(ret, 0xCF, ptr, 8);
+					return ret;
+				}
+				static void msgPackArrayHeader(std::string& out, const uint32_t count) {
+					_msgPackHeader(out, 0x90, 16, 0, 0xDC, 0xDD, count);
+				}
+				/// One value as the dump of a scalar node of that kind
+				static std::string scalarToText(const EnumScalarKind eScalarKind, const uint8_t* p, const bool dumpJson = false, const bool dumpMsgPack = false) {
+					std::string ret;
+					if ( dumpMsgPack ) {
+						_appendMsgPackScalar(ret, eScalarKind, p);
+						return ret;
+					}
+
+					const bool quotes = jsonScalarNeedQuotes(eScalarKind, scalarKindSize(eScalarKind), dumpJson);
+					if ( quotes )
+						ret += "\"";
+					_appendScalar(ret, eScalarKind, p);
+					if ( quotes )
+						ret += "\"";
+					return ret;
+				}
+
+				/// MessagePack array of __StructInfoNameList, index is the nameID used as map key
+				static const std::string& msgPackNameTable() {
+					static const std::string table = []() {
+						const uint32_t count = sizeof(__Local__::__StructInfoNameList) / sizeof(__Local__::__StructInfoNameList[0]);
+
+						std::string out;
+						_msgPackHeader(out, 0x90, 16, 0, 0xDC, 0xDD, count);
+						for(uint32_t i = 0; i != count; i++) {
+							const char* pName = __Local__::__StructInfoNameList[i];
+							const uint32_t length = static_cast< uint32_t >( strlen(pName) );
+							_msgPackHeader(out, 0xA0, 32, 0xD9, 0xDA, 0xDB, length);
+							out.append(pName, length);
+						}
+						return out;
+					}();
+
+					return table;
 				}
 		};
 		
@@ -370,6 +1600,11 @@ namespace ATF {
 			const auto dump = sd.dumpStruct(node, pData);
 			return std::make_pair(sd, dump);
 		}
+		auto diffStruct(const ATF::Reflect::Node& node, const uint8_t* pOld, const uint8_t* pNew, const TStructDumperOptions& dumperOptions = {}, const StructNodeExtends& nodeEx = {}) {
+			StructDumper sd(dumperOptions, nodeEx);
+			const auto diff = sd.diffStruct(getStructNodeView(node), pOld, pNew);
+			return std::make_pair(sd, diff);
+		}
 
 		std::string dumpStructType(const ATF::Reflect::Node& node, const StructNodeExtends& nodeEx = {}) {
 			if ( node.valid ) {
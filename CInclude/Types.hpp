@@ -2,7 +2,11 @@
 
 namespace ATF {
 
-	#define __CC_CDECL __cdecl
+	#ifdef _WIN32
+		#define __CC_CDECL __cdecl
+	#else
+		#define __CC_CDECL
+	#endif
 
 	using uchar16_t = uint16_t;
 	using float32_t = float;
@@ -2,6 +2,7 @@
 
 namespace ProcessMemoryReader {
 
+		#if defined(_WIN32)
 		class WinError {
 			private:
 				std::string _funcName      = "";
@@ -78,6 +79,7 @@ namespace ProcessMemoryReader {
 					return text;
 				}
 		};
+		#endif
 
 		class ErrorState {
 			private:
@@ -87,12 +89,14 @@ namespace ProcessMemoryReader {
 			public:
 				ErrorState() {}
 				ErrorState(const std::string& text) : _error(true), _errorText(text) {}
+				#if defined(_WIN32)
 				ErrorState(const WinError& e) {
 					if ( e.fail() ) {
 						_error = true;
 						_errorText = e.getErrorText();
 					}
 				}
+				#endif
 
 				auto fail() const { return _error; }
 				auto getErrorText() const { return _errorText; }
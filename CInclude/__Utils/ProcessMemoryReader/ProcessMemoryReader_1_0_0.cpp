@@ -1,11 +1,37 @@
 #pragma once
 
 #include "Common.cpp"
-#include "TCPMessageServer.cpp"
+#if defined(_WIN32)
+	#include "TCPMessageServer.cpp"
+#endif
 
 namespace ProcessMemoryReader {
 	namespace Ver_1_0_0 {
 	
+		/// Compiled address of an expression and its result: start (absolute or module relative), then per deref
+		/// one instruction "address = *address + offset". A steady-state request runs one step per pointer it follows
+		struct TAddressProgram {
+			uint64_t                start            = 0;
+			bool                    isModuleRelative = false;
+			std::vector< uint64_t > offsetList;
+			
+			int32_t nodeID    = 0;
+			bool    isAddress = false;		/// Result is the address itself (&x, numbers), else the node at the address is dumped
+			
+			/// fDeRef(address, value) reads the pointer at address
+			template< class TFunDeRef >
+			bool run(uint64_t& address, const uint64_t moduleBaseAddress, const TFunDeRef fDeRef) const {
+				address = isModuleRelative ? moduleBaseAddress + start : start;
+				for(const auto offset : offsetList) {
+					if ( !fDeRef(address, address) )
+						return false;
+					
+					address += offset;
+				}
+				return true;
+			}
+		};
+		
 		struct TAddressAccumulate {
 			enum Mode {
 				Abs,
@@ -28,28 +54,29 @@ namespace ProcessMemoryReader {
 			void relSub(const uint64_t value) { _list.push_back({ RelSub, value, }); }
 			void deRef() { _list.push_back({ DeRef, 0, }); }
 
-			template< class TFunDeRef >
-			uint64_t calcAddress(const uint64_t moduleBaseAddress, const TFunDeRef fDeRef) const {
-				uint64_t address = 0;
+			/// Bytecode of the steps: RelAdd/RelSub runs are folded into the start or into the offset after the previous deref
+			TAddressProgram compile() const {
+				TAddressProgram program;
 				
+				const auto offset = [&]() -> uint64_t& {
+					return program.offsetList.size() ? program.offsetList.back() : program.start;
+				};
 				for(const auto& e : _list) {
 					switch( e.eMode ) {
-						case Abs      : address = e.value; break;
-						case AbsModule: address = moduleBaseAddress + e.value; break;
-						case RelAdd   : address += e.value; break;
-						case RelSub   : address -= e.value; break;
-						case DeRef    : {
-							const auto rec = fDeRef(address);
-							if ( !rec.first )
-								return 0;
-							
-							address = rec.second;
-						}
-						break;
+						case Abs      :
+						case AbsModule:
+							program = TAddressProgram{};
+							program.start            = e.value;
+							program.isModuleRelative = e.eMode == AbsModule;
+							break;
+						
+						case RelAdd: offset() += e.value; break;
+						case RelSub: offset() -= e.value; break;
+						case DeRef : program.offsetList.push_back(0); break;
 					}
 				}
 				
-				return address;
+				return program;
 			}
 			
 			std::string getInfoText() const {
@@ -90,14 +117,15 @@ namespace ProcessMemoryReader {
 				}
 				
 		};
+		/// Only the last node is used, states stay cheap to move through the Builder stack
 		struct TNodeAccumulate {
 			using Node = ATF::Reflect::Node;
 
-			void push(Node n) { _list.push_back(n); }
-			Node back() const { return _list.size() ? _list.back() : Node{}; }
+			void push(const Node& n) { _node = n; }
+			const Node& back() const { return _node; }
 
 			private:
-				std::vector< Node > _list;
+				Node _node = {};
 		};
 		struct TState {
 			using EnumNodeType = ATF::Reflect::EnumNodeType;
@@ -144,12 +172,12 @@ namespace ProcessMemoryReader {
 
 		};
 		struct TStateStack {
-			void push(TState s) { _list.push_back(s); }
+			void push(TState&& s) { _list.push_back(std::move(s)); }
 			TState pop() {
 				if ( !_list.size() )
 					return TState{};
 							
-				auto ret = _list.back();
+				auto ret = std::move(_list.back());
 				_list.pop_back();
 				return ret;
 			}
@@ -158,6 +186,108 @@ namespace ProcessMemoryReader {
 				std::vector< TState > _list;
 		};
 		
+		/// MSVC x64 release layouts (_ITERATOR_DEBUG_LEVEL 0, no container proxy):
+		/// std::vector { _Myfirst, _Mylast, _Myend }, std::list and std::map { _Myhead, _Mysize },
+		/// list node { _Next, _Prev, _Myval }, tree node { _Left, _Parent, _Right, _Color, _Isnil, _Myval }
+		namespace MsvcStdLayout {
+			const uint64_t VectorFirst    = 0;
+			const uint64_t VectorLast     = 8;
+			const uint64_t ContainerHead  = 0;
+			const uint64_t ContainerSize  = 8;
+			const uint64_t ListNodeNext   = 0;
+			const uint64_t ListNodeValue  = 16;
+			const uint64_t TreeNodeLeft   = 0;
+			const uint64_t TreeNodeParent = 8;
+			const uint64_t TreeNodeRight  = 16;
+			const uint64_t TreeNodeValue  = 26;		/// Before alignment of the value type
+		}
+		
+		/// Scalar (or bitfield) field of the elements of a sequence, offset from the element address
+		struct TSeqField {
+			uint64_t                     offset      = 0;
+			ATF::Reflect::EnumScalarKind eScalarKind = ATF::Reflect::EnumScalarKind::None;
+			uint32_t                     shift       = 0;
+			uint32_t                     bits        = 0;		/// 0 - not a bitfield
+			
+			enum EnumColumn {
+				ColumnInt,
+				ColumnUInt,
+				ColumnFloat,
+			};
+			/// Values are widened to int64_t, uint64_t or double, bitfields are unsigned
+			EnumColumn column() const {
+				using ATF::Reflect::EnumScalarKind;
+				
+				if ( bits )
+					return ColumnUInt;
+				
+				switch( eScalarKind ) {
+					case EnumScalarKind::Int8   :
+					case EnumScalarKind::Int16  :
+					case EnumScalarKind::Int32  :
+					case EnumScalarKind::Int64  :
+					case EnumScalarKind::Char   : return ColumnInt;
+					case EnumScalarKind::Float32:
+					case EnumScalarKind::Float64: return ColumnFloat;
+					default:
+						break;
+				}
+				return ColumnUInt;
+			}
+		};
+		/// where(...) condition, NonZero for a bare field
+		struct TSeqFilter {
+			enum EnumCompare {
+				NonZero,
+				Eq,
+				Ne,
+				Lt,
+				Le,
+				Gt,
+				Ge,
+			};
+			
+			TSeqField   field;
+			EnumCompare eCompare = NonZero;
+			int64_t     iValue   = 0;
+			uint64_t    uValue   = 0;
+			double      fValue   = 0;
+		};
+		
+		/// each(...), std::vector/std::list/std::map adapters and arrays under where/select/count/sum/min/max. The state of the
+		/// expression resolves to the first element (each), the container object (std::*) or the array, elements are collected when the expression runs
+		struct TSequence {
+			enum EnumKind {
+				None,
+				Each,
+				StdVector,
+				StdList,
+				StdMap,
+				Array,
+			};
+			enum EnumAggregate {
+				AggregateNone,
+				AggregateCount,
+				AggregateSum,
+				AggregateMin,
+				AggregateMax,
+			};
+			
+			EnumKind           eKind        = None;
+			ATF::Reflect::Node elementNode;				/// Element type, key type of std::map
+			ATF::Reflect::Node valueNode;				/// Mapped type of std::map
+			uint64_t           linkOffset   = 0;		/// each: offset of the next pointer in the element
+			uint64_t           valueOffset  = 0;		/// std::map: offset of the value pair in the node
+			uint64_t           secondOffset = 0;		/// std::map: offset of the mapped value in the pair
+			uint64_t           arrayCount   = 0;		/// Array: element count
+			
+			ATF::Reflect::Node        itemNode;				/// Dumped part of the element, select(...) narrows it to a field
+			uint64_t                  itemOffset = 0;
+			std::vector< TSeqFilter > filterList;
+			EnumAggregate             eAggregate = AggregateNone;
+			TSeqField                 aggregateField;		/// sum/min/max
+		};
+		
 		/// ###############################################
 		class Lexer {
 			public:
@@ -171,7 +301,7 @@ namespace ProcessMemoryReader {
 				}
 				static bool isNumChar(char c, bool next = false) { return inRng('0', c, '9') || ( next && (inRng('a', c, 'f') || inRng('A', c, 'F') || inArr(c, "xX") ) ); }
 				static bool isWordChar(char c, bool next = false) { return inRng('a', c, 'z') || inRng('A', c, 'Z') || inArr(c, "_$") || ( next && inRng('0', c, '9') ); }
-				static bool isSymbol(char c) { return inArr(c, "()[]<>*."); }
+				static bool isSymbol(char c) { return inArr(c, "()[]<>*.:,=!-"); }
 				static bool isSpace(char c) { return inArr(c, "\r\n\x09\x20"); }
 
 				static bool isWordToken(const std::string& tok) {
@@ -189,8 +319,9 @@ namespace ProcessMemoryReader {
 
 				static constexpr const char* symbols[] = {
 					"::", "->",
+					"==", "!=", "<=", ">=",
 					"(", ")", "[", "]", "<", ">",
-					"*", ".", "&",
+					"*", ".", "&", ":", ",", "-",
 				};
 				
 				static const char* findSymbol(const char* pCur) {
@@ -260,12 +391,23 @@ namespace ProcessMemoryReader {
 					FetchMember,
 					FetchMemberDeRef,
 					FetchArray,
+					FetchSlice,
 					Var,
 					TypePointer,
 					Decltype,
 					ReinterpretCast,
 					DeRef,
 					ConstNumber,
+					Each,
+					StdVector,
+					StdList,
+					StdMap,
+					Where,
+					Select,
+					Count,
+					Sum,
+					Min,
+					Max,
 				};
 				static std::string opToString(const Op op) {
 					switch( op ) {
@@ -274,12 +416,23 @@ namespace ProcessMemoryReader {
 						case Op::FetchMember: return "FetchMember";
 						case Op::FetchMemberDeRef: return "FetchMemberDeRef";
 						case Op::FetchArray: return "FetchArray";
+						case Op::FetchSlice: return "FetchSlice";
 						case Op::Var: return "Var";
 						case Op::TypePointer: return "TypePointer";
 						case Op::Decltype: return "Decltype";
 						case Op::ReinterpretCast: return "ReinterpretCast";
 						case Op::DeRef: return "DeRef";
 						case Op::ConstNumber: return "ConstNumber";
+						case Op::Each: return "Each";
+						case Op::StdVector: return "StdVector";
+						case Op::StdList: return "StdList";
+						case Op::StdMap: return "StdMap";
+						case Op::Where: return "Where";
+						case Op::Select: return "Select";
+						case Op::Count: return "Count";
+						case Op::Sum: return "Sum";
+						case Op::Min: return "Min";
+						case Op::Max: return "Max";
 					}
 					return "*InvalidOp*";
 				};
@@ -331,6 +484,34 @@ namespace ProcessMemoryReader {
 						}
 						return ident;
 					};
+					/// name(, so a global ident with the same name still parses
+					const auto itFunc = [&](const std::string& name) {
+						if ( ( gt() != name ) || ( ti + 1 >= tokens.size() ) || ( tokens[ti + 1] != "(" ) )
+							return false;
+						
+						ti += 2;
+						return true;
+					};
+					const auto readFieldPath = [&]() {
+						std::string path = readIdent();
+						while( it(".") )
+							path += "." + readIdent();
+						return path;
+					};
+					/// [-]digits[.digits]
+					const auto readNumber = [&]() -> std::string {
+						std::string num = it("-") ? "-" : "";
+						if ( !Lexer::isNumToken(gt()) ) {
+							errorList.errorAdd("Expected number, got '", gt(), "'");
+							ti = 999999999;
+							return "";
+						}
+						
+						num += nt();
+						if ( it(".") )
+							num += "." + nt();
+						return num;
+					};
 				
 					TCmdList cmds;
 					
@@ -382,8 +563,82 @@ namespace ProcessMemoryReader {
 								continue;
 							}
 							
+							/// each(<first element or pointer to it>, -><next pointer member>)
+							if ( itFunc("each") ) {
+								readExpr();
+								at(",");
+								at("->");
+								cmds.push_back({ Op::Each, readIdent() });
+								at(")");
+								continue;
+							}
+							
+							/// where(<seq>, <field> [==|!=|<|<=|>|>= <number>]), select(<seq>, <field>), count(<seq>), sum/min/max(<seq>[, <field>]).
+							/// <seq> is an array, each(...) or std::* container, fields are dot paths in the element (none for arrays of scalars)
+							if ( itFunc("where") ) {
+								readExpr();
+								at(",");
+								std::string arg = Lexer::isWordToken(gt()) ? readFieldPath() : std::string("");
+								for(const auto compare : { "==", "!=", "<", "<=", ">", ">=" }) {
+									if ( it(compare) ) {
+										arg += std::string(" ") + compare + " " + readNumber();
+										break;
+									}
+								}
+								at(")");
+								cmds.push_back({ Op::Where, arg });
+								continue;
+							}
+							
+							if ( itFunc("select") ) {
+								readExpr();
+								at(",");
+								cmds.push_back({ Op::Select, readFieldPath() });
+								at(")");
+								continue;
+							}
+							
+							if ( itFunc("count") ) {
+								readExpr();
+								at(")");
+								cmds.push_back({ Op::Count });
+								continue;
+							}
+							
+							{
+								const bool isSum = itFunc("sum");
+								const bool isMin = !isSum && itFunc("min");
+								const bool isMax = !isSum && !isMin && itFunc("max");
+								if ( isSum || isMin || isMax ) {
+									readExpr();
+									const auto path = it(",") ? readFieldPath() : std::string("");
+									at(")");
+									cmds.push_back({ isSum ? Op::Sum : isMin ? Op::Min : Op::Max, path });
+									continue;
+								}
+							}
+							
 							if ( Lexer::isWordToken(gt()) ) {
-								cmds.push_back({ Op::GlobalIdent, readIdent() });
+								const auto ident = readIdent();
+								
+								/// std::vector<T>(<container>), std::list<T>(...), std::map<K, V>(...)
+								const bool isStdMap = ident == "std::map";
+								if ( ( isStdMap || ident == "std::vector" || ident == "std::list" ) && it("<") ) {
+									readExpr();
+									if ( isStdMap ) {
+										at(",");
+										readExpr();
+									}
+									at(">");
+									
+									at("(");
+									readExpr();
+									at(")");
+									cmds.push_back({ isStdMap ? Op::StdMap : ( ident == "std::vector" ) ? Op::StdVector : Op::StdList });
+									continue;
+								}
+								
+								cmds.push_back({ Op::GlobalIdent, ident });
 								continue;
 							}
 							
@@ -402,8 +657,15 @@ namespace ProcessMemoryReader {
 								continue;
 							}
 							
+							/// [N] or slice [a:b], a defaults to 0, b to the array count (required for pointers)
 							if ( it("[") ) {
-								cmds.push_back({ Op::FetchArray, nt() });
+								const std::string first = ( gt() == ":" ) ? "" : nt();
+								if ( it(":") ) {
+									const std::string last = ( gt() == "]" ) ? "" : nt();
+									cmds.push_back({ Op::FetchSlice, first + ":" + last });
+								} else {
+									cmds.push_back({ Op::FetchArray, first });
+								}
 								at("]");
 								continue;
 							}
@@ -446,26 +708,155 @@ namespace ProcessMemoryReader {
 					return node;
 				}
 
-				TState _state;
-
-			public:
-			
-				static const auto& getNodeNameMap() {
-					static std::mutex _mutex;
-					std::lock_guard< std::mutex > lg(_mutex);
+				TState    _state;
+				TSequence _seq;
+				
+				/// Natural alignment from the reflected layout (packed structs are not detected)
+				uint32_t _alignOf(const int32_t nodeID, const uint32_t depth = 0) {
+					using namespace ATF::Reflect;
+					
+					const auto node = _nodeEx.getNodeView(nodeID);
+					if ( depth > 32 )
+						return 8;
+					
+					switch( node.type() ) {
+						case EnumNodeType::TypeScalar:
+							return std::max< uint32_t >( 1, std::min< uint32_t >( node.size(), 8 ) );
+						
+						case EnumNodeType::TypePointer:
+							return 8;
+						
+						case EnumNodeType::TypeBitfield:
+						case EnumNodeType::TypeArray:
+							return _alignOf(node.elementTypeID(), depth + 1);
+						
+						case EnumNodeType::TypeStruct:
+						case EnumNodeType::TypeClass:
+						case EnumNodeType::TypeUnion: {
+							uint32_t align = 1;
+							for(const auto fieldNode : fields(node))
+								if ( fieldNode.type() == EnumNodeType::TypeDataMemberField )
+									align = std::max(align, _alignOf(fieldNode.elementTypeID(), depth + 1));
+							return align;
+						}
+						
+						default:
+							break;
+					}
+					return 1;
+				}
+				static uint64_t _alignUp(const uint64_t value, const uint64_t align) {
+					return ( value + align - 1 ) / align * align;
+				}
+				
+				/// Source of where/select/count/sum/min/max: a sequence built before or an array l-value
+				bool _seqStage(TStateStack& stateStack, TState& state, const char* pName) {
+					state = stateStack.pop();
+					if ( _seq.eKind != TSequence::None ) {
+						if ( ( _seq.eKind == TSequence::StdMap ) && ( std::string(pName) != "count" ) ) {
+							errorAdd("Invalid " + std::string(pName) + ", not supported for std::map.");
+							return false;
+						}
+						return true;
+					}
+					
+					if ( !state.check({ TState::LValue, TState::Address }, { ATF::Reflect::EnumNodeType::TypeArray }) ) {
+						errorAdd("Invalid " + std::string(pName) + ", expected an array, each or std container.");
+						return false;
+					}
+					
+					const auto nodeItem = _getNode( state.nodeAcc.back().typeArray.elementTypeID );
+					if ( !nodeItem.valid || !nodeItem.size )
+						return false;
+					
+					_seq.eKind       = TSequence::Array;
+					_seq.elementNode = nodeItem;
+					_seq.itemNode    = nodeItem;
+					_seq.arrayCount  = state.nodeAcc.back().size / nodeItem.size;
+					return true;
+				}
+				/// Dot path from the current item of the sequence, empty for the item itself
+				bool _seqFieldNode(const std::string& path, ATF::Reflect::Node& node, uint64_t& offset) {
+					using namespace ATF::Reflect;
+					
+					node   = _seq.itemNode;
+					offset = _seq.itemOffset;
+					for(size_t pos = 0; pos < path.length(); ) {
+						size_t end = path.find('.', pos);
+						if ( end == std::string::npos )
+							end = path.length();
+						
+						const auto name = path.substr(pos, end - pos);
+						pos = end + 1;
+						
+						const auto fieldNode = findStructField(node, name.c_str());
+						if ( !fieldNode.valid ) {
+							errorAdd("Invalid field '"+path+"', '"+name+"' member not found.");
+							return false;
+						}
+						
+						offset += fieldNode.typeDataMemberField.offset;
+						node    = _getNode( fieldNode.typeDataMemberField.elementTypeID );
+						if ( !node.valid )
+							return false;
+					}
+					return true;
+				}
+				bool _seqField(const std::string& path, TSeqField& field) {
+					using namespace ATF::Reflect;
+					
+					Node node;
+					if ( !_seqFieldNode(path, node, field.offset) )
+						return false;
+					
+					if ( node.eNodeType == EnumNodeType::TypeBitfield ) {
+						field.shift = node.typeBitfield.startingPosition;
+						field.bits  = node.typeBitfield.bits;
+						node        = _getNode( node.typeBitfield.elementTypeID );
+					}
 					
-					static std::unordered_map< std::string, ATF::Reflect::Node > nodeNameMap;
-					if ( nodeNameMap.size() )
-						return nodeNameMap;
+					field.eScalarKind = ( node.eNodeType == EnumNodeType::TypeScalar ) ? node.typeScalar.eScalarKind : EnumScalarKind::None;
+					if ( ( field.eScalarKind == EnumScalarKind::None ) || ( field.eScalarKind == EnumScalarKind::HRESULT ) || ( scalarKindSize(field.eScalarKind) != node.size ) ) {
+						errorAdd("Invalid field '"+path+"', expected a number or bool.");
+						return false;
+					}
+					return true;
+				}
+				
+				/// Container object of std::* adapters: l-value is the container, address points to it. The state becomes its address
+				bool _popContainer(TStateStack& stateStack, TState& state, const char* pName, const size_t typeCount) {
+					state = stateStack.pop();
+					
+					std::vector< ATF::Reflect::Node > typeList( typeCount );
+					for(size_t i = typeCount; i--; ) {
+						const auto typeState = stateStack.pop();
+						if ( !typeState.check({ TState::Type }) || !typeState.nodeAcc.back().size ) {
+							errorAdd("Invalid " + std::string(pName) + ", invalid element type.");
+							return false;
+						}
+						typeList[i] = typeState.nodeAcc.back();
+					}
 					
-					ATF::Reflect::eachStructNode([&](auto node) {
-						if ( strlen(node.name) )
-							nodeNameMap[ node.name ] = node;
-					});
+					if ( !state.valid || !( state.eType == TState::LValue || state.eType == TState::Address ) ) {
+						errorAdd("Invalid " + std::string(pName) + ", invalid container l-value/address.");
+						return false;
+					}
 					
-					return nodeNameMap;
+					_seq.elementNode = typeList[0];
+					_seq.itemNode    = typeList[0];
+					if ( typeCount > 1 )
+						_seq.valueNode = typeList[1];
+					
+					state.nodeAcc.push( _nodeEx.createNodePointer( _seq.elementNode ) );
+					state.eType = TState::Address;
+					return true;
 				}
+
+			public:
 				
+				/// Slices are read with one contiguous read
+				static constexpr uint64_t MaxSliceSize = 64 << 20;
+			
 				static auto strToU64(const std::string& str) {
 					std::stringstream sst;
 					if ( str.length() >= 2 && str[0] == '0' && Lexer::inArr(str[1], "xX") ) {
@@ -478,34 +869,27 @@ namespace ProcessMemoryReader {
 					sst >> value;
 					return std::make_pair( sst.fail(), value );
 				}
-				static auto findDataMemberField(const ATF::Reflect::Node& node, const char* pFieldName) {
-					ATF::Reflect::Node ret;
-					eachStructField(node, [&](const auto& fieldNode) {
-						if ( !strcmp(fieldNode.name, pFieldName) )
-							ret = fieldNode;
-					});
-					return ret;
-				}
-
 				Builder(const Parser::TCmdList& cmds) {
 					using namespace ATF::Reflect;
 					
 					using Op = Parser::Op;
 
-					const auto& nodeNameMap = getNodeNameMap();
-					
 					TStateStack stateStack;
-					for(auto c : cmds) {
+					for(const auto& c : cmds) {
+						const bool isSeqStage = ( c.op == Op::Where ) || ( c.op == Op::Select ) || ( c.op == Op::Count ) || ( c.op == Op::Sum ) || ( c.op == Op::Min ) || ( c.op == Op::Max );
+						if ( ( ( _seq.eKind != TSequence::None ) && !isSeqStage ) || ( _seq.eAggregate != TSequence::AggregateNone ) ) {
+							errorAdd("each, std containers and sequence functions must be the outermost expression.");
+							break;
+						}
+						
 						switch( c.op ) {
 							case Op::GlobalIdent: {
-								const auto rec = nodeNameMap.find(c.arg);
-								if ( rec == nodeNameMap.end() ) {
+								const auto node = findStructNodeByName(c.arg.c_str());
+								if ( !node.valid ) {
 									errorAdd("Global ident '"+c.arg+"' not found.");
 									break;
 								}
 								
-								const auto node = rec->second;
-								
 								TState state = { true, TState::Type };
 								state.nodeAcc.push( node );
 								
@@ -520,7 +904,7 @@ namespace ProcessMemoryReader {
 									}
 								}
 								
-								stateStack.push(state);
+								stateStack.push( std::move(state) );
 							}
 							break;
 							
@@ -537,7 +921,7 @@ namespace ProcessMemoryReader {
 								if ( state.check({ TState::Type }) ) {
 									const auto newNode = _nodeEx.createNodeArray( state.nodeAcc.back(), index );
 									state.nodeAcc.push( newNode );
-									stateStack.push( state );
+									stateStack.push( std::move(state) );
 									break;
 								}
 								
@@ -557,7 +941,7 @@ namespace ProcessMemoryReader {
 										
 										state.addrAcc.relAdd( nodeItem.size * index );
 										state.nodeAcc.push( nodeItem );
-										stateStack.push( state );
+										stateStack.push( std::move(state) );
 									}
 									break;
 										
@@ -568,7 +952,7 @@ namespace ProcessMemoryReader {
 											state.addrAcc.deRef();
 										state.addrAcc.relAdd( nodeItem.size * index );
 										state.nodeAcc.push( nodeItem );
-										stateStack.push( state );
+										stateStack.push( std::move(state) );
 									}
 									break;
 									
@@ -579,6 +963,65 @@ namespace ProcessMemoryReader {
 							}
 							break;
 							
+							case Op::FetchSlice: {
+								auto state = stateStack.pop();
+								if ( !state.check({ TState::LValue, TState::Address }, { EnumNodeType::TypeArray, EnumNodeType::TypePointer }) ) {
+									errorAdd("Invalid slice, invalid l-value/address ["+c.arg+"].");
+									break;
+								}
+								
+								const auto nodeItem = _getNode( state.nodeAcc.back().typeArray.elementTypeID );
+								if ( !nodeItem.valid || !nodeItem.size ) {
+									errorAdd("Invalid slice, invalid element type ["+c.arg+"].");
+									break;
+								}
+								
+								const bool isArray = state.nodeAcc.back().eNodeType == EnumNodeType::TypeArray;
+								const uint64_t arrCount = isArray ? state.nodeAcc.back().size / nodeItem.size : 0;
+								
+								const auto sep = c.arg.find(':');
+								const auto firstText = c.arg.substr(0, sep);
+								const auto lastText  = c.arg.substr(sep + 1);
+								
+								uint64_t first = 0;
+								uint64_t last  = arrCount;
+								if ( firstText.length() ) {
+									const auto rec = strToU64(firstText);
+									if ( rec.first ) {
+										errorAdd("Invalid uint number '"+firstText+"'.");
+										break;
+									}
+									first = rec.second;
+								}
+								if ( lastText.length() ) {
+									const auto rec = strToU64(lastText);
+									if ( rec.first ) {
+										errorAdd("Invalid uint number '"+lastText+"'.");
+										break;
+									}
+									last = rec.second;
+								} else if ( !isArray ) {
+									errorAdd("Invalid slice, pointer slice needs an end index ["+c.arg+"].");
+									break;
+								}
+								
+								if ( ( first > last ) || ( isArray && ( last > arrCount ) ) ) {
+									errorAdd("Invalid slice, invalid range ["+c.arg+"], have array count "+std::to_string(arrCount)+".");
+									break;
+								}
+								if ( last - first > MaxSliceSize / nodeItem.size ) {
+									errorAdd("Invalid slice, range ["+c.arg+"] is larger than "+std::to_string(MaxSliceSize)+" bytes.");
+									break;
+								}
+								
+								if ( !isArray && state.check({ TState::LValue }) )
+									state.addrAcc.deRef();
+								state.addrAcc.relAdd( nodeItem.size * first );
+								state.nodeAcc.push( _nodeEx.createNodeArray( nodeItem, last - first ) );
+								stateStack.push( std::move(state) );
+							}
+							break;
+							
 							case Op::FetchMemberDeRef: {
 								auto state = stateStack.pop();
 								if ( !state.check({ TState::LValue, TState::Address }, { EnumNodeType::TypePointer }) ) {
@@ -591,7 +1034,7 @@ namespace ProcessMemoryReader {
 								if ( state.check({ TState::LValue }) )
 									state.addrAcc.deRef();
 								state.eType = TState::LValue;
-								stateStack.push(state);
+								stateStack.push( std::move(state) );
 							}
 							case Op::FetchMember: {
 								auto state = stateStack.pop();
@@ -604,7 +1047,7 @@ namespace ProcessMemoryReader {
 									case EnumNodeType::TypeStruct:
 									case EnumNodeType::TypeClass:
 									case EnumNodeType::TypeUnion: {
-										const auto fieldNode = findDataMemberField(state.nodeAcc.back(), c.arg.c_str());
+										const auto fieldNode = findStructField(state.nodeAcc.back(), c.arg.c_str());
 										if ( !fieldNode.valid ) {
 											errorAdd("Invalid fetch member, '."+c.arg+"' member not found.");
 											break;
@@ -614,7 +1057,7 @@ namespace ProcessMemoryReader {
 										
 										state.addrAcc.relAdd( fieldNode.typeDataMemberField.offset );
 										state.nodeAcc.push( finalNode );
-										stateStack.push( state );
+										stateStack.push( std::move(state) );
 									}
 									break;
 									
@@ -635,7 +1078,7 @@ namespace ProcessMemoryReader {
 								const auto newNode = _nodeEx.createNodePointer( state.nodeAcc.back() );
 								state.nodeAcc.push( newNode );
 								state.eType = TState::Address;
-								stateStack.push( state );
+								stateStack.push( std::move(state) );
 							}
 							break;
 							
@@ -651,7 +1094,7 @@ namespace ProcessMemoryReader {
 								if ( state.check({ TState::LValue }) )
 									state.addrAcc.deRef();
 								state.eType = TState::LValue;
-								stateStack.push(state);
+								stateStack.push( std::move(state) );
 							}
 							break;
 							
@@ -664,7 +1107,7 @@ namespace ProcessMemoryReader {
 								
 								const auto newNode = _nodeEx.createNodePointer( state.nodeAcc.back() );
 								state.nodeAcc.push( newNode );
-								stateStack.push( state );
+								stateStack.push( std::move(state) );
 							}
 							break;
 							
@@ -687,7 +1130,7 @@ namespace ProcessMemoryReader {
 								}
 								
 								stateR.nodeAcc.push( stateL.nodeAcc.back() );
-								stateStack.push(stateR);
+								stateStack.push( std::move(stateR) );
 							};
 							break;
 							
@@ -699,7 +1142,7 @@ namespace ProcessMemoryReader {
 								}
 								
 								state.eType = TState::Type;
-								stateStack.push( state );
+								stateStack.push( std::move(state) );
 							};
 							break;
 							
@@ -713,7 +1156,141 @@ namespace ProcessMemoryReader {
 								
 								TState state = { true, TState::Address };
 								state.addrAcc.abs( num );
-								stateStack.push( state );
+								stateStack.push( std::move(state) );
+							}
+							break;
+							
+							case Op::Each: {
+								auto state = stateStack.pop();
+								if ( !state.check({ TState::LValue, TState::Address }) ) {
+									errorAdd("Invalid each, invalid l-value/address.");
+									break;
+								}
+								
+								if ( state.nodeAcc.back().eNodeType == EnumNodeType::TypePointer ) {
+									const auto nextNode = _getNode( state.nodeAcc.back().typePointer.elementTypeID );
+									state.nodeAcc.push( nextNode );
+									if ( state.check({ TState::LValue }) )
+										state.addrAcc.deRef();
+									state.eType = TState::LValue;
+								}
+								
+								const auto elementNode = state.nodeAcc.back();
+								const auto linkNode = findStructField(elementNode, c.arg.c_str());
+								if ( !state.check({ TState::LValue }) || !linkNode.valid ) {
+									errorAdd("Invalid each, '->"+c.arg+"' member not found.");
+									break;
+								}
+								if ( _getNode( linkNode.typeDataMemberField.elementTypeID ).eNodeType != EnumNodeType::TypePointer ) {
+									errorAdd("Invalid each, '->"+c.arg+"' is not a pointer.");
+									break;
+								}
+								
+								_seq.eKind       = TSequence::Each;
+								_seq.elementNode = elementNode;
+								_seq.itemNode    = elementNode;
+								_seq.linkOffset  = linkNode.typeDataMemberField.offset;
+								stateStack.push( std::move(state) );
+							}
+							break;
+							
+							case Op::StdVector:
+							case Op::StdList: {
+								const bool isVector = c.op == Op::StdVector;
+								
+								TState state;
+								if ( !_popContainer(stateStack, state, isVector ? "std::vector" : "std::list", 1) )
+									break;
+								
+								_seq.eKind = isVector ? TSequence::StdVector : TSequence::StdList;
+								stateStack.push( std::move(state) );
+							}
+							break;
+							
+							case Op::StdMap: {
+								TState state;
+								if ( !_popContainer(stateStack, state, "std::map", 2) )
+									break;
+								
+								/// std::pair< const K, V >
+								const uint64_t keyAlign   = _alignOf( _seq.elementNode.id );
+								const uint64_t valueAlign = _alignOf( _seq.valueNode.id );
+								
+								_seq.eKind        = TSequence::StdMap;
+								_seq.valueOffset  = _alignUp( MsvcStdLayout::TreeNodeValue, std::max(keyAlign, valueAlign) );
+								_seq.secondOffset = _alignUp( _seq.elementNode.size, valueAlign );
+								stateStack.push( std::move(state) );
+							}
+							break;
+							
+							case Op::Where: {
+								TState state;
+								if ( !_seqStage(stateStack, state, "where") )
+									break;
+								
+								/// "<field>" or "<field> <compare> <number>"
+								const auto sep = c.arg.find(' ');
+								const auto path = c.arg.substr(0, sep);
+								
+								TSeqFilter filter;
+								if ( !_seqField(path, filter.field) )
+									break;
+								
+								if ( sep != std::string::npos ) {
+									const auto sep2    = c.arg.find(' ', sep + 1);
+									const auto compare = c.arg.substr(sep + 1, sep2 - sep - 1);
+									const auto number  = c.arg.substr(sep2 + 1);
+									
+									const std::vector< std::string > compareList = { "", "==", "!=", "<", "<=", ">", ">=" };
+									filter.eCompare = static_cast< TSeqFilter::EnumCompare >( std::find(compareList.begin(), compareList.end(), compare) - compareList.begin() );
+									
+									char* pEnd = nullptr;
+									switch( filter.field.column() ) {
+										case TSeqField::ColumnInt  : filter.iValue = strtoll (number.c_str(), &pEnd, 0); break;
+										case TSeqField::ColumnUInt : filter.uValue = strtoull(number.c_str(), &pEnd, 0); break;
+										case TSeqField::ColumnFloat: filter.fValue = strtod  (number.c_str(), &pEnd   ); break;
+									}
+									if ( !pEnd || *pEnd || ( ( filter.field.column() == TSeqField::ColumnUInt ) && ( number[0] == '-' ) ) ) {
+										errorAdd("Invalid number '"+number+"' for field '"+path+"'.");
+										break;
+									}
+								}
+								
+								_seq.filterList.push_back( filter );
+								stateStack.push( std::move(state) );
+							}
+							break;
+							
+							case Op::Select: {
+								TState state;
+								if ( !_seqStage(stateStack, state, "select") )
+									break;
+								
+								if ( !_seqFieldNode(c.arg, _seq.itemNode, _seq.itemOffset) )
+									break;
+								
+								stateStack.push( std::move(state) );
+							}
+							break;
+							
+							case Op::Count:
+							case Op::Sum:
+							case Op::Min:
+							case Op::Max: {
+								const char* pName = ( c.op == Op::Count ) ? "count" : ( c.op == Op::Sum ) ? "sum" : ( c.op == Op::Min ) ? "min" : "max";
+								
+								TState state;
+								if ( !_seqStage(stateStack, state, pName) )
+									break;
+								
+								if ( ( c.op != Op::Count ) && !_seqField(c.arg, _seq.aggregateField) )
+									break;
+								
+								_seq.eAggregate =
+									( c.op == Op::Count ) ? TSequence::AggregateCount :
+									( c.op == Op::Sum   ) ? TSequence::AggregateSum   :
+									( c.op == Op::Min   ) ? TSequence::AggregateMin   : TSequence::AggregateMax;
+								stateStack.push( std::move(state) );
 							}
 							break;
 							
@@ -737,31 +1314,433 @@ namespace ProcessMemoryReader {
 
 				auto getNodeEx() const { return _nodeEx; }
 				auto getState() const { return _state; }
+				auto getSequence() const { return _seq; }
 		};
 
 
 		/// ###############################################
-		class WinHandle : public WinError {
-			private:
-				HANDLE const _hValue = INVALID_HANDLE_VALUE;
-
+		/// One range of MemorySource::readMemoryList, data is sized by the caller. Same record as the graph dumper reads
+		using TMemoryRead = ATF::Reflect::TGraphRead;
+		
+		struct TMemoryRegion {
+			uint64_t address = 0;
+			uint64_t size    = 0;
+		};
+		
+		/// Target memory, backends implement _readDirect (and _readDirectList when the OS has vectored reads).
+		/// readMemory/readMemoryList go through the page cache when it is on
+		class MemorySource {
 			public:
-				static bool isValidHandle(HANDLE h) { return (h != NULL) && (h != INVALID_HANDLE_VALUE); }
+				/// CacheEpoch: pages are read on first use and kept until the epoch advances.
+				/// CacheConsistent: advanceEpoch re-reads the pages used in the last epoch at once (unused pages are dropped), requests see one snapshot.
+				/// A full cache evicts the least recently used page
+				enum EnumCacheMode {
+					CacheOff,
+					CacheEpoch,
+					CacheConsistent,
+				};
 				
-				WinHandle(const std::string& funcName, const HANDLE hValue, const DWORD ec) : 
-					WinError(funcName, !isValidHandle(hValue) || ( ec != 0 ), ec), 
-					_hValue(hValue) {}
-
-				HANDLE getHandle() const { return _hValue; }
+				static constexpr uint64_t PageSize      = 4096;
+				static constexpr size_t   MaxCachePages = 16384;
 				
-				~WinHandle() {
-					if ( isValidHandle(_hValue) ) {
-						::CloseHandle(_hValue);
-					}
-				}
-		};
-		using SP_WinHandle = std::shared_ptr< WinHandle >;
-		SP_WinHandle CreateWinHandle(const char* pFuncName, const HANDLE hValue) {
+				/// A region map miss refreshes the map at most this often. Misses inside the window of a refresh younger than this are rejected,
+				/// other misses while the refresh is throttled leave the range unknown and try the read
+				static constexpr int64_t  RegionRefreshMs = 50;
+				
+			protected:
+				std::string _errorText = "";
+				
+			private:
+				/// Page index -> page data, nullptr if the page is not readable as a whole (reads fall back to exact ranges)
+				using SP_TPage = std::shared_ptr< const std::vector< uint8_t > >;
+				
+				/// useEpoch: last epoch a request used the page, lruIt: its place in _pageLru
+				struct TCachedPage {
+					SP_TPage                        page;
+					uint64_t                        useEpoch = 0;
+					std::list< uint64_t >::iterator lruIt;
+				};
+				
+				mutable std::mutex                                   _cacheMutex;
+				mutable std::unordered_map< uint64_t, TCachedPage >  _pageMap;
+				mutable std::list< uint64_t >                        _pageLru;		/// Page indices, most recently used first
+				std::atomic< EnumCacheMode >                     _eCacheMode    { CacheOff };
+				std::atomic< uint64_t >                          _epoch         { 1 };
+				mutable std::atomic< uint64_t >                  _pageHitCount  { 0 };
+				mutable std::atomic< uint64_t >                  _pageMissCount { 0 };
+				
+				/// Region map: readable regions sorted by address, not overlapping (adjacent regions stay separate)
+				mutable std::shared_timed_mutex         _regionMutex;
+				mutable std::vector< TMemoryRegion >    _regionList;
+				std::atomic< bool >                     _regionCheck       { false };
+				mutable std::atomic< int64_t >          _regionRefreshTime { 0 };
+				mutable std::atomic< uint64_t >         _regionRejectCount { 0 };
+				
+				/// Window and time of the last map refresh, guarded by _regionMutex
+				mutable uint64_t                        _regionFreshBegin  = 0;
+				mutable uint64_t                        _regionFreshEnd    = 0;
+				mutable int64_t                         _regionFreshTime   = 0;
+				
+				static int64_t _nowMs() {
+					return std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+				}
+				
+				SP_TPage _readPage(const uint64_t pageIndex) const {
+					auto memRec = _readDirect(pageIndex * PageSize, PageSize);
+					if ( memRec.first.length() )
+						return nullptr;
+					
+					return memRec.second;
+				}
+				/// Caller holds _cacheMutex
+				void _usePage(TCachedPage& cached) const {
+					_pageLru.splice(_pageLru.begin(), _pageLru, cached.lruIt);
+					cached.useEpoch = _epoch;
+				}
+				void _clearPages() const {
+					_pageMap.clear();
+					_pageLru.clear();
+				}
+				
+				/// End of the readable span (adjacent regions) containing address, 0 if address is not in the map. Caller holds _regionMutex
+				uint64_t _readableEnd(const uint64_t address) const {
+					auto it = std::upper_bound(_regionList.begin(), _regionList.end(), address, 
+						[](const uint64_t address, const TMemoryRegion& region) { return address < region.address; });
+					if ( it == _regionList.begin() )
+						return 0;
+					
+					--it;
+					if ( address - it->address >= it->size )
+						return 0;
+					
+					uint64_t end = it->address + it->size;
+					for(++it; ( it != _regionList.end() ) && ( it->address == end ); ++it)
+						end += it->size;
+					
+					return end;
+				}
+				uint64_t _lockedReadableEnd(const uint64_t address) const {
+					std::shared_lock< std::shared_timed_mutex > lock(_regionMutex);
+					return _readableEnd(address);
+				}
+				/// Replaces the map content inside [windowBegin, windowEnd) with regionList, queried at time
+				void _replaceRegions(const uint64_t windowBegin, const uint64_t windowEnd, const std::vector< TMemoryRegion >& regionList, const int64_t time) const {
+					std::unique_lock< std::shared_timed_mutex > lock(_regionMutex);
+					
+					_regionList.erase( std::remove_if(_regionList.begin(), _regionList.end(), [&](const TMemoryRegion& region) {
+						return ( region.address < windowEnd ) && ( region.address + region.size > windowBegin );
+					}), _regionList.end() );
+					
+					_regionList.insert(_regionList.end(), regionList.begin(), regionList.end());
+					std::sort(_regionList.begin(), _regionList.end(), [](const TMemoryRegion& l, const TMemoryRegion& r) { return l.address < r.address; });
+					
+					_regionFreshBegin = windowBegin;
+					_regionFreshEnd   = windowEnd;
+					_regionFreshTime  = time;
+				}
+				/// Misses refresh the part of the map around the range, at most once per RegionRefreshMs.
+				/// True if the map is fresh for the range (refreshed now or inside the window of a refresh younger than RegionRefreshMs),
+				/// false if the refresh is throttled and the range is unknown
+				bool _refreshRegions(const uint64_t address, const uint64_t size) const {
+					const int64_t now = _nowMs();
+					{
+						std::shared_lock< std::shared_timed_mutex > lock(_regionMutex);
+						if ( ( now - _regionFreshTime < RegionRefreshMs ) && ( address >= _regionFreshBegin ) && ( address + size <= _regionFreshEnd ) )
+							return true;
+					}
+					
+					int64_t last = _regionRefreshTime;
+					if ( ( now - last < RegionRefreshMs ) || !_regionRefreshTime.compare_exchange_strong(last, now) )
+						return false;
+					
+					uint64_t windowBegin = address;
+					uint64_t windowEnd   = address + size;
+					const auto regionList = _queryRegionList(windowBegin, windowEnd);
+					_replaceRegions(windowBegin, windowEnd, regionList, now);
+					return true;
+				}
+				/// A read failed inside the map (freed or protected since the last refresh): only the pages of the range leave the map,
+				/// the rest of their regions stays. The next access to those pages refreshes the map or tries the read
+				void _dropRegions(const uint64_t address, const uint64_t size) const {
+					if ( !_regionCheck || !size )
+						return;
+					
+					const uint64_t dropBegin = address / PageSize * PageSize;
+					const uint64_t dropEnd   = ( address + size - 1 ) / PageSize * PageSize + PageSize;
+					
+					std::unique_lock< std::shared_timed_mutex > lock(_regionMutex);
+					
+					std::vector< TMemoryRegion > regionList;
+					for(const auto& region : _regionList) {
+						const uint64_t regionEnd = region.address + region.size;
+						if ( ( region.address >= dropEnd ) || ( regionEnd <= dropBegin ) ) {
+							regionList.push_back(region);
+							continue;
+						}
+						
+						if ( region.address < dropBegin )
+							regionList.push_back({ region.address, dropBegin - region.address });
+						if ( ( regionEnd > dropEnd ) && dropEnd )
+							regionList.push_back({ dropEnd, regionEnd - dropEnd });
+					}
+					_regionList.swap(regionList);
+				}
+				std::pair< std::string, std::shared_ptr< std::vector< uint8_t > > > _rejectRead(const uint64_t address, const uint64_t size) const {
+					_regionRejectCount++;
+					return std::make_pair( ATF::Reflect::stringFormat( "[",(void*)address, "(",size,")] Not in a readable region" ), std::make_shared< std::vector< uint8_t > >(size) );
+				}
+				std::pair< std::string, std::shared_ptr< std::vector< uint8_t > > > _readDirectChecked(const uint64_t address, const uint64_t size) const {
+					auto memRec = _readDirect(address, size);
+					if ( memRec.first.length() )
+						_dropRegions(address, size);
+					
+					return memRec;
+				}
+				void _readMemoryList(std::vector< TMemoryRead >& readList) const {
+					if ( _eCacheMode == CacheOff ) {
+						_readDirectList(readList);
+						return;
+					}
+					
+					for(auto& read : readList) {
+						read.ok = true;
+						if ( read.data.empty() )
+							continue;
+						
+						auto memRec = readMemory(read.address, read.data.size());
+						read.ok = !memRec.first.length();
+						if ( read.ok )
+							read.data.swap(*memRec.second);
+					}
+				}
+				
+			protected:
+				virtual std::pair< std::string, std::shared_ptr< std::vector< uint8_t > > > _readDirect(const uint64_t address, const uint64_t size) const = 0;
+				
+				virtual void _readDirectList(std::vector< TMemoryRead >& readList) const {
+					for(auto& read : readList) {
+						read.ok = true;
+						if ( read.data.empty() )
+							continue;
+						
+						auto memRec = _readDirect(read.address, read.data.size());
+						read.ok = !memRec.first.length();
+						if ( read.ok )
+							read.data.swap(*memRec.second);
+					}
+				}
+				
+				/// Regions for a region map refresh of [windowBegin, windowEnd). The backend may widen the window to what it queried,
+				/// the map inside the window is replaced by the result. Default: all regions, the window becomes the whole address space
+				virtual std::vector< TMemoryRegion > _queryRegionList(uint64_t& windowBegin, uint64_t& windowEnd) const {
+					windowBegin = 0;
+					windowEnd   = UINT64_MAX;
+					return getRegionList();
+				}
+				
+			public:
+				virtual ~MemorySource() {}
+				
+				auto getErrorText() const { return _errorText; }
+				
+				/// Pointer to [address, address + size) without copying, valid while the source lives. nullptr if the backend can't
+				virtual const uint8_t* view(const uint64_t address, const uint64_t size) const { return nullptr; }
+				
+				/// Readable (committed) regions of the target
+				virtual std::vector< TMemoryRegion > getRegionList() const { return {}; }
+				
+				void setCacheMode(const EnumCacheMode eCacheMode) {
+					_eCacheMode = eCacheMode;
+					
+					std::lock_guard< std::mutex > lg(_cacheMutex);
+					_clearPages();
+				}
+				/// Starts a new snapshot, returns its number
+				uint64_t advanceEpoch() {
+					if ( _eCacheMode != CacheConsistent ) {
+						std::lock_guard< std::mutex > lg(_cacheMutex);
+						_clearPages();
+						return ++_epoch;
+					}
+					
+					/// Pages used in the ending epoch, in LRU order
+					const uint64_t epoch = _epoch;
+					std::vector< TMemoryRead > readList;
+					{
+						std::lock_guard< std::mutex > lg(_cacheMutex);
+						for(const auto pageIndex : _pageLru) {
+							const auto& cached = _pageMap.at(pageIndex);
+							if ( cached.page && ( cached.useEpoch == epoch ) )
+								readList.push_back({ pageIndex * PageSize, std::vector< uint8_t >(PageSize), false });
+						}
+					}
+					
+					/// Requests keep using the previous snapshot until all pages of the new one are read
+					_readDirectList(readList);
+					
+					std::unordered_map< uint64_t, TCachedPage > newPageMap;
+					std::list< uint64_t >                       newPageLru;
+					for(auto& read : readList) {
+						const uint64_t pageIndex = read.address / PageSize;
+						newPageLru.push_back(pageIndex);
+						newPageMap[ pageIndex ] = { read.ok ? std::make_shared< const std::vector< uint8_t > >( std::move(read.data) ) : nullptr, epoch, std::prev(newPageLru.end()) };
+					}
+					
+					std::lock_guard< std::mutex > lg(_cacheMutex);
+					_pageMap.swap(newPageMap);
+					_pageLru.swap(newPageLru);
+					return ++_epoch;
+				}
+				/// Reads outside the known readable regions fail without a system call
+				void setRegionCheck(const bool enabled) {
+					if ( enabled ) {
+						const int64_t now = _nowMs();
+						auto regionList = getRegionList();
+						_replaceRegions(0, UINT64_MAX, regionList, now);
+					}
+					
+					_regionCheck = enabled;
+				}
+				bool isReadable(const uint64_t address, const uint64_t size) const {
+					if ( !_regionCheck || !size )
+						return true;
+					
+					if ( address + size < address )
+						return false;
+					
+					if ( _lockedReadableEnd(address) >= address + size )
+						return true;
+					
+					/// Only a fresh map rejects, a range unknown because of a throttled refresh is left to the read
+					if ( !_refreshRegions(address, size) )
+						return true;
+					
+					return _lockedReadableEnd(address) >= address + size;
+				}
+				/// End of the readable span containing address (UINT64_MAX without region checks, 0 if not readable or unknown)
+				uint64_t getReadableEnd(const uint64_t address) const {
+					if ( !_regionCheck )
+						return UINT64_MAX;
+					
+					const uint64_t end = _lockedReadableEnd(address);
+					if ( end || !_refreshRegions(address, 1) )
+						return end;
+					
+					return _lockedReadableEnd(address);
+				}
+				uint64_t getRegionRejectCount() const { return _regionRejectCount; }
+				
+				uint64_t getEpoch        () const { return _epoch; }
+				uint64_t getPageHitCount () const { return _pageHitCount; }
+				uint64_t getPageMissCount() const { return _pageMissCount; }
+				
+				std::pair< std::string, std::shared_ptr< std::vector< uint8_t > > > readMemory(const uint64_t address, const uint64_t size) const {
+					if ( !isReadable(address, size) )
+						return _rejectRead(address, size);
+					
+					if ( ( _eCacheMode == CacheOff ) || !size )
+						return _readDirectChecked(address, size);
+					
+					auto mem = std::make_shared< std::vector< uint8_t > >(size);
+					
+					const uint64_t firstPage = address / PageSize;
+					const uint64_t lastPage  = ( address + size - 1 ) / PageSize;
+					for(uint64_t pageIndex = firstPage; pageIndex <= lastPage; pageIndex++) {
+						SP_TPage page;
+						bool found = false;
+						{
+							std::lock_guard< std::mutex > lg(_cacheMutex);
+							const auto it = _pageMap.find(pageIndex);
+							if ( it != _pageMap.end() ) {
+								_usePage(it->second);
+								page  = it->second.page;
+								found = true;
+							}
+						}
+						
+						if ( found ) {
+							_pageHitCount++;
+						} else {
+							_pageMissCount++;
+							page = _readPage(pageIndex);
+							
+							std::lock_guard< std::mutex > lg(_cacheMutex);
+							auto it = _pageMap.find(pageIndex);
+							if ( it == _pageMap.end() ) {
+								while( _pageMap.size() >= MaxCachePages ) {
+									_pageMap.erase(_pageLru.back());
+									_pageLru.pop_back();
+								}
+								
+								_pageLru.push_front(pageIndex);
+								it = _pageMap.emplace(pageIndex, TCachedPage{ page, 0, _pageLru.begin() }).first;
+							}
+							_usePage(it->second);
+							page = it->second.page;
+						}
+						
+						if ( !page )
+							return _readDirectChecked(address, size);
+						
+						const uint64_t pageAddress = pageIndex * PageSize;
+						const uint64_t begin = std::max(address, pageAddress);
+						const uint64_t end   = std::min(address + size, pageAddress + PageSize);
+						memcpy(&(*mem)[ begin - address ], &(*page)[ begin - pageAddress ], end - begin);
+					}
+					
+					return std::make_pair( std::string(""), mem );
+				}
+				/// Reads many ranges at once (one system call per batch where the backend supports it), sets ok per range
+				void readMemoryList(std::vector< TMemoryRead >& readList) const {
+					if ( !_regionCheck ) {
+						_readMemoryList(readList);
+						return;
+					}
+					
+					std::vector< size_t >      indexList;
+					std::vector< TMemoryRead > checkedList;
+					for(size_t i = 0; i != readList.size(); i++) {
+						auto& read = readList[i];
+						if ( !isReadable(read.address, read.data.size()) ) {
+							_regionRejectCount++;
+							read.ok = false;
+							continue;
+						}
+						
+						indexList.push_back(i);
+						checkedList.push_back( std::move(read) );
+					}
+					
+					_readMemoryList(checkedList);
+					
+					for(size_t i = 0; i != indexList.size(); i++)
+						readList[ indexList[i] ] = std::move( checkedList[i] );
+				}
+		};
+		using SP_MemorySource = std::shared_ptr< MemorySource >;
+		
+		#if defined(_WIN32)
+		class WinHandle : public WinError {
+			private:
+				HANDLE const _hValue = INVALID_HANDLE_VALUE;
+
+			public:
+				static bool isValidHandle(HANDLE h) { return (h != NULL) && (h != INVALID_HANDLE_VALUE); }
+				
+				WinHandle(const std::string& funcName, const HANDLE hValue, const DWORD ec) : 
+					WinError(funcName, !isValidHandle(hValue) || ( ec != 0 ), ec), 
+					_hValue(hValue) {}
+
+				HANDLE getHandle() const { return _hValue; }
+				
+				~WinHandle() {
+					if ( isValidHandle(_hValue) ) {
+						::CloseHandle(_hValue);
+					}
+				}
+		};
+		using SP_WinHandle = std::shared_ptr< WinHandle >;
+		SP_WinHandle CreateWinHandle(const char* pFuncName, const HANDLE hValue) {
 			const DWORD lastErrorCode = WinHandle::isValidHandle(hValue) ? 0 : ::GetLastError();
 			
 			return std::make_shared< WinHandle >( std::string(pFuncName), hValue, lastErrorCode );
@@ -791,10 +1770,44 @@ namespace ProcessMemoryReader {
 			return std::make_pair( std::string(""), candsProcesIdList[0] );
 		}
 
-		class WinReadProcessMemory {
+		class WinReadProcessMemory : public MemorySource {
 			private:
-				std::string  _errorText = "";
-				SP_WinHandle _process   = nullptr;
+				SP_WinHandle _process = nullptr;
+				
+				void _open(const DWORD processId) {
+					auto newProcess = CreateWinHandle("OpenProcess", OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, processId));
+					if ( newProcess->fail() ) {
+						_errorText = newProcess->getErrorText();
+						return;
+					}
+
+					_process = newProcess;
+				}
+				
+			protected:
+				std::pair< std::string, std::shared_ptr< std::vector< uint8_t > > > _readDirect(const uint64_t address, const uint64_t size) const override {
+					auto mem = std::make_shared< std::vector< uint8_t > >();
+					mem->resize(size);
+					
+					auto retFalse = [&](auto err) {
+						return std::make_pair( ATF::Reflect::stringFormat( "[",(void*)address, "(",size,")] ", err ), mem );
+					};
+					
+					if ( !_process )
+						return retFalse("No init");
+					
+					SIZE_T numberOfBytesRead = 0;
+					const auto rmStatus = WinError::checkBool("ReadProcessMemory", 
+						::ReadProcessMemory( _process->getHandle(), (LPCVOID)address, (LPVOID)&((*mem)[0]), (SIZE_T)mem->size(), (SIZE_T*)&numberOfBytesRead ) );
+					
+					if ( rmStatus.fail() )
+						return retFalse( rmStatus.getErrorText() );
+					
+					if ( mem->size() != numberOfBytesRead )
+						return retFalse("Only part of a ReadProcessMemory or WriteProcessMemory request was completed");
+					
+					return std::make_pair( std::string(""), mem );
+				}
 				
 			public:
 				WinReadProcessMemory(const std::string& processName) {
@@ -803,18 +1816,114 @@ namespace ProcessMemoryReader {
 					if ( _errorText.length() ) 
 						return;
 
-					auto newProcess = CreateWinHandle("OpenProcess", OpenProcess(PROCESS_VM_READ, FALSE, prcRec.second));
-					if ( newProcess->fail() ) {
-						_errorText = newProcess->getErrorText();
-						return;
+					_open(prcRec.second);
+				}
+				WinReadProcessMemory(const DWORD processId) {
+					_open(processId);
+				}
+				
+				std::vector< TMemoryRegion > getRegionList() const override {
+					uint64_t windowBegin = 0;
+					uint64_t windowEnd   = UINT64_MAX;
+					return _walkRegions(windowBegin, windowEnd);
+				}
+				
+			private:
+				/// VirtualQueryEx from the region containing windowBegin up to windowEnd, the window is widened to the queried regions
+				std::vector< TMemoryRegion > _walkRegions(uint64_t& windowBegin, uint64_t& windowEnd) const {
+					std::vector< TMemoryRegion > regionList;
+					if ( !_process )
+						return regionList;
+					
+					const uint64_t queryEnd = windowEnd;
+					windowEnd = windowBegin;
+					
+					MEMORY_BASIC_INFORMATION mbi = {};
+					for(uint64_t address = windowBegin; ( address < queryEnd ) && ( ::VirtualQueryEx(_process->getHandle(), (LPCVOID)address, &mbi, sizeof(mbi)) == sizeof(mbi) ); ) {
+						const uint64_t regionAddress = (uint64_t)mbi.BaseAddress;
+						const uint64_t regionEnd     = regionAddress + (uint64_t)mbi.RegionSize;
+						if ( ( mbi.State == MEM_COMMIT ) && !( mbi.Protect & ( PAGE_NOACCESS | PAGE_GUARD ) ) )
+							regionList.push_back({ regionAddress, (uint64_t)mbi.RegionSize });
+						
+						windowBegin = std::min(windowBegin, regionAddress);
+						windowEnd   = std::max(windowEnd, regionEnd);
+						if ( regionEnd <= address )
+							break;
+						
+						address = regionEnd;
 					}
-
-					_process = newProcess;
+					
+					return regionList;
 				}
+				
+			protected:
+				/// Only the regions around the missing range, one VirtualQueryEx per region
+				std::vector< TMemoryRegion > _queryRegionList(uint64_t& windowBegin, uint64_t& windowEnd) const override {
+					return _walkRegions(windowBegin, windowEnd);
+				}
+		};
+		#endif
+		
+		#if defined(__linux__)
+		/// Finds the pid by /proc/<pid>/comm (truncated to 15 chars by the kernel) or the file name of /proc/<pid>/exe
+		auto linux_FindOnceProcessIdByProcessName(const std::string& processName) {
+			std::vector< pid_t > candsProcesIdList;
+			
+			DIR* pDir = opendir("/proc");
+			if ( !pDir )
+				return std::make_pair( ATF::Reflect::stringFormat("opendir(/proc): ", strerror(errno)), (pid_t)0 );
+			
+			while( const dirent* pEntry = readdir(pDir) ) {
+				char* pEnd = nullptr;
+				const long pid = strtol(pEntry->d_name, &pEnd, 10);
+				if ( ( pid <= 0 ) || *pEnd )
+					continue;
+				
+				const std::string procDir = std::string("/proc/") + pEntry->d_name;
+				
+				std::string comm;
+				std::getline( std::ifstream(procDir + "/comm"), comm );
+				
+				char exePath[4096] = {};
+				const auto exePathLen = readlink( (procDir + "/exe").c_str(), exePath, sizeof(exePath) - 1 );
+				const char* pExeName = ( exePathLen > 0 ) ? strrchr(exePath, '/') : nullptr;
+				
+				if ( ( comm == processName ) || ( pExeName && ( processName == pExeName + 1 ) ) )
+					candsProcesIdList.push_back( (pid_t)pid );
+			}
+			closedir(pDir);
+			
+			if ( candsProcesIdList.size() == 0 )
+				return std::make_pair( ATF::Reflect::stringFormat("Process '", processName, "' not found"), (pid_t)0 );
+					
+			if ( candsProcesIdList.size() != 1 )
+				return std::make_pair( ATF::Reflect::stringFormat("Process '", processName, "' found more 1(",candsProcesIdList.size(),")"), (pid_t)0 );
 
-				auto getErrorText() const { return _errorText; }
-
-				auto readMemory(const uint64_t address, const uint64_t size) const {
+			return std::make_pair( std::string(""), candsProcesIdList[0] );
+		}
+		
+		/// process_vm_readv, or pread on /proc/<pid>/mem where the syscall is not available (ENOSYS, some sandboxes).
+		/// Both need ptrace access to the target (same user and ptrace_scope, or CAP_SYS_PTRACE)
+		class LinuxReadProcessMemory : public MemorySource {
+			private:
+				pid_t _pid   = 0;
+				int   _memFd = -1;
+				
+				/// Per call limit of process_vm_readv
+				static constexpr size_t MaxIovCount = 1024;
+				
+				void _open(const pid_t pid) {
+					if ( kill(pid, 0) && ( errno == ESRCH ) ) {
+						_errorText = ATF::Reflect::stringFormat("Process ", pid, " not found");
+						return;
+					}
+					
+					_pid   = pid;
+					_memFd = open( ATF::Reflect::stringFormat("/proc/", pid, "/mem").c_str(), O_RDONLY | O_CLOEXEC );
+				}
+				
+			protected:
+				std::pair< std::string, std::shared_ptr< std::vector< uint8_t > > > _readDirect(const uint64_t address, const uint64_t size) const override {
 					auto mem = std::make_shared< std::vector< uint8_t > >();
 					mem->resize(size);
 					
@@ -822,79 +1931,1393 @@ namespace ProcessMemoryReader {
 						return std::make_pair( ATF::Reflect::stringFormat( "[",(void*)address, "(",size,")] ", err ), mem );
 					};
 					
-					if ( !_process )
-						return retFalse("No init");
+					if ( !_pid )
+						return retFalse("No init");
+					
+					if ( !size )
+						return std::make_pair( std::string(""), mem );
+					
+					iovec local  = { &(*mem)[0], (size_t)size };
+					iovec remote = { (void*)address, (size_t)size };
+					ssize_t numberOfBytesRead = process_vm_readv(_pid, &local, 1, &remote, 1, 0);
+					
+					if ( ( numberOfBytesRead < 0 ) && ( errno != EFAULT ) && ( _memFd >= 0 ) )
+						numberOfBytesRead = pread(_memFd, &(*mem)[0], (size_t)size, (off_t)address);
+					
+					if ( numberOfBytesRead < 0 )
+						return retFalse( ATF::Reflect::stringFormat("process_vm_readv: ", strerror(errno)) );
+					
+					if ( (uint64_t)numberOfBytesRead != size )
+						return retFalse("Only part of a process_vm_readv request was completed");
+					
+					return std::make_pair( std::string(""), mem );
+				}
+				
+				/// One process_vm_readv per MaxIovCount ranges. The call stops at the first range it cannot read,
+				/// that range is retried alone (and reported) and the call continues after it
+				void _readDirectList(std::vector< TMemoryRead >& readList) const override {
+					std::vector< iovec > localList;
+					std::vector< iovec > remoteList;
+					std::vector< size_t > indexList;
+					
+					for(size_t i = 0; i != readList.size(); ) {
+						localList.clear();
+						remoteList.clear();
+						indexList.clear();
+						for(size_t j = i; ( j != readList.size() ) && ( indexList.size() != MaxIovCount ); j++) {
+							auto& read = readList[j];
+							read.ok = read.data.empty();
+							if ( read.ok )
+								continue;
+							
+							localList .push_back({ &read.data[0], read.data.size() });
+							remoteList.push_back({ (void*)read.address, read.data.size() });
+							indexList .push_back(j);
+						}
+						if ( indexList.empty() )
+							break;
+						
+						ssize_t numberOfBytesRead = process_vm_readv(_pid, &localList[0], localList.size(), &remoteList[0], remoteList.size(), 0);
+						if ( numberOfBytesRead < 0 )
+							numberOfBytesRead = 0;
+						
+						size_t k = 0;
+						for(; k != indexList.size(); k++) {
+							auto& read = readList[ indexList[k] ];
+							if ( (size_t)numberOfBytesRead < read.data.size() )
+								break;
+							
+							numberOfBytesRead -= read.data.size();
+							read.ok = true;
+						}
+						
+						if ( k == indexList.size() ) {
+							i = indexList.back() + 1;
+							continue;
+						}
+						
+						auto& read = readList[ indexList[k] ];
+						auto memRec = _readDirect(read.address, read.data.size());
+						read.ok = !memRec.first.length();
+						if ( read.ok )
+							read.data.swap(*memRec.second);
+						
+						i = indexList[k] + 1;
+					}
+				}
+				
+			public:
+				LinuxReadProcessMemory(const std::string& processName) {
+					const auto prcRec = linux_FindOnceProcessIdByProcessName(processName);
+					_errorText = prcRec.first;
+					if ( _errorText.length() ) 
+						return;
+					
+					_open(prcRec.second);
+				}
+				LinuxReadProcessMemory(const pid_t pid) {
+					_open(pid);
+				}
+				~LinuxReadProcessMemory() {
+					if ( _memFd >= 0 )
+						close(_memFd);
+				}
+				
+				/// Readable mappings of /proc/<pid>/maps ("start-end perms ..."), [vsyscall] is not readable through process_vm_readv
+				std::vector< TMemoryRegion > getRegionList() const override {
+					std::vector< TMemoryRegion > regionList;
+					if ( !_pid )
+						return regionList;
+					
+					std::ifstream maps( ATF::Reflect::stringFormat("/proc/", _pid, "/maps") );
+					for(std::string line; std::getline(maps, line); ) {
+						unsigned long long regionAddress = 0;
+						unsigned long long regionEnd     = 0;
+						char perms[8] = {};
+						if ( sscanf(line.c_str(), "%llx-%llx %7s", &regionAddress, &regionEnd, perms) != 3 )
+							continue;
+						
+						if ( ( perms[0] != 'r' ) || ( line.find("[vsyscall]") != std::string::npos ) || ( regionEnd <= regionAddress ) )
+							continue;
+						
+						regionList.push_back({ (uint64_t)regionAddress, (uint64_t)( regionEnd - regionAddress ) });
+					}
+					
+					return regionList;
+				}
+		};
+		#endif
+		
+		/// ###############################################
+		/// Snapshot file: header, raw data of the captured regions at page aligned offsets, region table (sorted by address) at tableOffset
+		#pragma pack(push, 1)
+		struct TSnapshotHeader {
+			char     magic[8]    = {};
+			uint32_t version     = 0;
+			uint32_t regionCount = 0;
+			uint64_t tableOffset = 0;
+			uint64_t baseAddress = 0;
+		};
+		struct TSnapshotRegion {
+			uint64_t address    = 0;
+			uint64_t size       = 0;
+			uint64_t fileOffset = 0;
+		};
+		#pragma pack(pop)
+		
+		const char     SnapshotMagic[8]  = { 'P', 'M', 'R', 'S', 'N', 'A', 'P', '\0' };
+		const uint32_t SnapshotVersion   = 1;
+		const uint64_t SnapshotChunkSize = 1 << 20;
+		
+		/// Read-only mapping of a snapshot file, view() points into the mapping so plans run on it without copies
+		class SnapshotMemorySource : public MemorySource {
+			private:
+				const uint8_t*                 _pBase       = nullptr;
+				uint64_t                       _fileSize    = 0;
+				uint64_t                       _baseAddress = 0;
+				std::vector< TSnapshotRegion > _regionTable;
+				
+				#if defined(_WIN32)
+					SP_WinHandle _file    = nullptr;
+					SP_WinHandle _mapping = nullptr;
+				#endif
+				
+				bool _map(const std::string& path) {
+					#if defined(_WIN32)
+						_file = CreateWinHandle("CreateFileA", ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+						if ( _file->fail() ) {
+							_errorText = _file->getErrorText();
+							return false;
+						}
+						
+						LARGE_INTEGER fileSize = {};
+						const auto sizeStatus = WinError::checkBool("GetFileSizeEx", ::GetFileSizeEx(_file->getHandle(), &fileSize));
+						if ( sizeStatus.fail() ) {
+							_errorText = sizeStatus.getErrorText();
+							return false;
+						}
+						_fileSize = (uint64_t)fileSize.QuadPart;
+						
+						_mapping = CreateWinHandle("CreateFileMappingA", ::CreateFileMappingA(_file->getHandle(), NULL, PAGE_READONLY, 0, 0, NULL));
+						if ( _mapping->fail() ) {
+							_errorText = _mapping->getErrorText();
+							return false;
+						}
+						
+						_pBase = (const uint8_t*)::MapViewOfFile(_mapping->getHandle(), FILE_MAP_READ, 0, 0, 0);
+						if ( !_pBase ) {
+							_errorText = WinError::checkBool("MapViewOfFile", false).getErrorText();
+							return false;
+						}
+					#elif defined(__linux__)
+						const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+						if ( fd < 0 ) {
+							_errorText = ATF::Reflect::stringFormat("open('", path, "'): ", strerror(errno));
+							return false;
+						}
+						
+						struct stat st = {};
+						if ( fstat(fd, &st) || !st.st_size ) {
+							close(fd);
+							_errorText = "Invalid snapshot (size)";
+							return false;
+						}
+						
+						void* pMap = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+						close(fd);
+						
+						if ( pMap == MAP_FAILED ) {
+							_errorText = ATF::Reflect::stringFormat("mmap('", path, "'): ", strerror(errno));
+							return false;
+						}
+						
+						_pBase    = (const uint8_t*)pMap;
+						_fileSize = (uint64_t)st.st_size;
+					#endif
+					
+					return true;
+				}
+				
+				const TSnapshotRegion* _findRegion(const uint64_t address, const uint64_t size) const {
+					auto it = std::upper_bound(_regionTable.begin(), _regionTable.end(), address, 
+						[](const uint64_t address, const TSnapshotRegion& region) { return address < region.address; });
+					if ( it == _regionTable.begin() )
+						return nullptr;
+					
+					--it;
+					if ( ( address - it->address > it->size ) || ( size > it->size - ( address - it->address ) ) )
+						return nullptr;
+					
+					return &(*it);
+				}
+				
+			protected:
+				std::pair< std::string, std::shared_ptr< std::vector< uint8_t > > > _readDirect(const uint64_t address, const uint64_t size) const override {
+					auto mem = std::make_shared< std::vector< uint8_t > >();
+					mem->resize(size);
+					
+					const uint8_t* pData = view(address, size);
+					if ( !pData )
+						return std::make_pair( ATF::Reflect::stringFormat( "[",(void*)address, "(",size,")] Not in snapshot" ), mem );
+					
+					if ( size )
+						memcpy(&(*mem)[0], pData, size);
+					
+					return std::make_pair( std::string(""), mem );
+				}
+				
+			public:
+				SnapshotMemorySource(const std::string& path) {
+					if ( !_map(path) )
+						return;
+					
+					TSnapshotHeader header;
+					if ( _fileSize < sizeof(header) ) {
+						_errorText = "Invalid snapshot (size)";
+						return;
+					}
+					
+					memcpy(&header, _pBase, sizeof(header));
+					if ( memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) || ( header.version != SnapshotVersion ) ) {
+						_errorText = "Invalid snapshot (magic/version)";
+						return;
+					}
+					
+					const uint64_t tableSize = (uint64_t)header.regionCount * sizeof(TSnapshotRegion);
+					if ( ( header.tableOffset > _fileSize ) || ( tableSize > _fileSize - header.tableOffset ) ) {
+						_errorText = "Invalid snapshot (region table)";
+						return;
+					}
+					
+					_regionTable.resize(header.regionCount);
+					if ( tableSize )
+						memcpy(&_regionTable[0], _pBase + header.tableOffset, tableSize);
+					
+					for(const auto& region : _regionTable) {
+						if ( ( region.fileOffset > _fileSize ) || ( region.size > _fileSize - region.fileOffset ) ) {
+							_errorText = "Invalid snapshot (region out of file)";
+							_regionTable.clear();
+							return;
+						}
+					}
+					
+					_baseAddress = header.baseAddress;
+				}
+				~SnapshotMemorySource() {
+					if ( !_pBase )
+						return;
+					
+					#if defined(_WIN32)
+						::UnmapViewOfFile(_pBase);
+					#elif defined(__linux__)
+						munmap((void*)_pBase, (size_t)_fileSize);
+					#endif
+				}
+				
+				uint64_t getBaseAddress() const { return _baseAddress; }
+				
+				const uint8_t* view(const uint64_t address, const uint64_t size) const override {
+					const auto pRegion = _findRegion(address, size);
+					if ( !pRegion )
+						return nullptr;
+					
+					return _pBase + pRegion->fileOffset + ( address - pRegion->address );
+				}
+				
+				std::vector< TMemoryRegion > getRegionList() const override {
+					std::vector< TMemoryRegion > regionList;
+					for(const auto& region : _regionTable)
+						regionList.push_back({ region.address, region.size });
+					
+					return regionList;
+				}
+		};
+		
+		/// Reads all readable regions of memSrc with numThreads readers (SnapshotChunkSize pieces) and writes a snapshot file.
+		/// Pieces that fail to read as a whole are read page by page, unreadable pages are left out of the region table
+		std::string captureSnapshot(const std::string& path, SP_MemorySource memSrc, const uint64_t baseAddress, const size_t numThreads) {
+			struct TChunk {
+				uint64_t                     address    = 0;
+				uint64_t                     size       = 0;
+				uint64_t                     fileOffset = 0;
+				std::vector< TMemoryRegion > partList;
+			};
+			std::vector< TChunk > chunkList;
+			
+			/// The first page holds the header
+			auto regionList = memSrc->getRegionList();
+			std::sort(regionList.begin(), regionList.end(), [](const TMemoryRegion& l, const TMemoryRegion& r) { return l.address < r.address; });
+			
+			uint64_t fileOffset = MemorySource::PageSize;
+			for(const auto& region : regionList) {
+				for(uint64_t offset = 0; offset < region.size; offset += SnapshotChunkSize) {
+					TChunk chunk;
+					chunk.address    = region.address + offset;
+					chunk.size       = std::min(SnapshotChunkSize, region.size - offset);
+					chunk.fileOffset = fileOffset;
+					chunkList.push_back(chunk);
+					
+					fileOffset += ( chunk.size + MemorySource::PageSize - 1 ) / MemorySource::PageSize * MemorySource::PageSize;
+				}
+			}
+			
+			if ( chunkList.empty() )
+				return "No readable regions";
+			
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if ( !file )
+				return ATF::Reflect::stringFormat("Can't create '", path, "'");
+			
+			std::mutex            fileMutex;
+			std::atomic< size_t > nextChunk { 0 };
+			const auto fWorker = [&]() {
+				for(size_t i; ( i = nextChunk++ ) < chunkList.size(); ) {
+					auto& chunk = chunkList[i];
+					
+					auto memRec = memSrc->readMemory(chunk.address, chunk.size);
+					auto data = memRec.second;
+					if ( !memRec.first.length() ) {
+						chunk.partList.push_back({ chunk.address, chunk.size });
+					} else {
+						data = std::make_shared< std::vector< uint8_t > >(chunk.size);
+						for(uint64_t offset = 0; offset < chunk.size; offset += MemorySource::PageSize) {
+							const uint64_t size = std::min(MemorySource::PageSize, chunk.size - offset);
+							auto pageRec = memSrc->readMemory(chunk.address + offset, size);
+							if ( pageRec.first.length() )
+								continue;
+							
+							memcpy(&(*data)[ offset ], &(*pageRec.second)[0], size);
+							
+							auto& partList = chunk.partList;
+							if ( !partList.empty() && ( partList.back().address + partList.back().size == chunk.address + offset ) )
+								partList.back().size += size;
+							else
+								partList.push_back({ chunk.address + offset, size });
+						}
+					}
+					
+					std::lock_guard< std::mutex > lg(fileMutex);
+					for(const auto& part : chunk.partList) {
+						file.seekp( chunk.fileOffset + ( part.address - chunk.address ) );
+						file.write( (const char*)&(*data)[ part.address - chunk.address ], part.size );
+					}
+				}
+			};
+			
+			std::vector< std::thread > threadList;
+			for(size_t i = 0; i < std::max< size_t >(numThreads, 1); i++)
+				threadList.emplace_back(fWorker);
+			for(auto& thread : threadList)
+				thread.join();
+			
+			/// Parts of neighbouring chunks of one region are contiguous in the file too
+			std::vector< TSnapshotRegion > regionTable;
+			for(const auto& chunk : chunkList) {
+				for(const auto& part : chunk.partList) {
+					const uint64_t partFileOffset = chunk.fileOffset + ( part.address - chunk.address );
+					if ( !regionTable.empty() &&
+						( regionTable.back().address    + regionTable.back().size == part.address   ) &&
+						( regionTable.back().fileOffset + regionTable.back().size == partFileOffset ) ) {
+						regionTable.back().size += part.size;
+						continue;
+					}
+					
+					TSnapshotRegion region;
+					region.address    = part.address;
+					region.size       = part.size;
+					region.fileOffset = partFileOffset;
+					regionTable.push_back(region);
+				}
+			}
+			
+			TSnapshotHeader header;
+			memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+			header.version     = SnapshotVersion;
+			header.regionCount = (uint32_t)regionTable.size();
+			header.tableOffset = fileOffset;
+			header.baseAddress = baseAddress;
+			
+			file.seekp(fileOffset);
+			if ( !regionTable.empty() )
+				file.write( (const char*)&regionTable[0], regionTable.size() * sizeof(TSnapshotRegion) );
+			file.seekp(0);
+			file.write( (const char*)&header, sizeof(header) );
+			file.close();
+			
+			if ( !file )
+				return ATF::Reflect::stringFormat("Write '", path, "' failed");
+			
+			return "";
+		}
+
+		/// Dump controls of a request, "maxDepth=2;maxArray=16;fields=m_Pos.*,m_dwHP" (see TStructDumperOptions).
+		/// "ptrDepth=N" dumps the object graph (StructDumper::dumpGraph) following pointers N hops
+		struct TDumpLimits {
+			uint32_t    maxDepth         = 0;
+			uint32_t    maxArrayElements = 0;
+			std::string fields;
+			uint32_t    pointerDepth     = 0;
+		};
+		std::string parseDumpLimits(TDumpLimits& limits, const std::string& text) {
+			size_t pos = 0;
+			while( pos < text.length() ) {
+				size_t end = text.find(';', pos);
+				if ( end == std::string::npos )
+					end = text.length();
+
+				const std::string item = text.substr(pos, end - pos);
+				pos = end + 1;
+				if ( !item.length() )
+					continue;
+
+				const size_t eq = item.find('=');
+				if ( eq == std::string::npos )
+					return "Invalid dump option '" + item + "', expected key=value";
+
+				const std::string key   = item.substr(0, eq);
+				const std::string value = item.substr(eq + 1);
+				if ( key == "fields" ) {
+					limits.fields = value;
+					continue;
+				}
+
+				const auto rec = Builder::strToU64(value);
+				if ( rec.first || ( rec.second > 0xFFFFFFFF ) )
+					return "Invalid dump option value '" + item + "'";
+
+				if ( key == "maxDepth" ) {
+					limits.maxDepth = (uint32_t)rec.second;
+					continue;
+				}
+				if ( key == "maxArray" ) {
+					limits.maxArrayElements = (uint32_t)rec.second;
+					continue;
+				}
+				if ( key == "ptrDepth" ) {
+					limits.pointerDepth = (uint32_t)rec.second;
+					continue;
+				}
+
+				return "Unknown dump option '" + key + "'";
+			}
+
+			return "";
+		}
+
+		/// Lexer + Parser + Builder result of one expression, fake nodes of the program live in nodeEx
+		struct TCompiledExpr {
+			TAddressProgram                 program;
+			ATF::Reflect::StructNodeExtends nodeEx;
+			TSequence                       seq;
+			
+			/// Plan of the last dump options used, steady-state requests skip StructDumper setup and the DumpPlanCache lookup.
+			/// Held weakly, plans are owned (and counted) by DumpPlanCache only: an evicted or uncached plan is compiled again
+			std::shared_ptr< const ATF::Reflect::DumpPlan > getPlan(const bool dumpJson, const bool dumpMsgPack, const TDumpLimits& limits) const {
+				{
+					std::lock_guard< std::mutex > lock(_planMutex);
+					if ( ( _planDumpJson == dumpJson ) && ( _planDumpMsgPack == dumpMsgPack ) &&
+						( _planLimits.maxDepth == limits.maxDepth ) && ( _planLimits.maxArrayElements == limits.maxArrayElements ) && ( _planLimits.fields == limits.fields ) )
+						if ( const auto plan = _plan.lock() )
+							return plan;
+				}
+				
+				ATF::Reflect::StructDumper sd({ dumpJson, 1, nullptr, dumpMsgPack, limits.maxDepth, limits.maxArrayElements, limits.fields.c_str(), }, nodeEx);
+				const auto plan = sd.getPlan( nodeEx.getNodeView(program.nodeID) );
+				
+				std::lock_guard< std::mutex > lock(_planMutex);
+				_plan            = plan;
+				_planDumpJson    = dumpJson;
+				_planDumpMsgPack = dumpMsgPack;
+				_planLimits      = limits;
+				return plan;
+			}
+			
+			private:
+				mutable std::mutex                                      _planMutex;
+				mutable std::weak_ptr< const ATF::Reflect::DumpPlan >   _plan;
+				mutable bool                                            _planDumpJson    = false;
+				mutable bool                                            _planDumpMsgPack = false;
+				mutable TDumpLimits                                     _planLimits;
+		};
+		using SP_TCompiledExpr = std::shared_ptr< const TCompiledExpr >;
+		
+		std::pair< std::string, SP_TCompiledExpr > compileExpr(const std::string& code) {
+			const auto tokRec = Lexer::getTokens(code);
+			if ( tokRec.first.errorHas() )
+				return std::make_pair( tokRec.first.errorGetFirst(), SP_TCompiledExpr() );
+
+			const auto cmdRec = Parser::parse(tokRec.second);
+			if ( cmdRec.first.errorHas() )
+				return std::make_pair( cmdRec.first.errorGetFirst(), SP_TCompiledExpr() );
+			
+			Builder builder(cmdRec.second);
+			if ( builder.errorHas() )
+				return std::make_pair( builder.errorGetFirst(), SP_TCompiledExpr() );
+			
+			const auto state = builder.getState();
+			if ( !state.check({ TState::LValue, TState::Address }) )
+				return std::make_pair( std::string("Invalid type state, expected l-value/address"), SP_TCompiledExpr() );
+			
+			auto expr = std::make_shared< TCompiledExpr >();
+			expr->program           = state.addrAcc.compile();
+			expr->program.nodeID    = state.nodeAcc.back().id;
+			expr->program.isAddress = state.eType == TState::Address;
+			expr->nodeEx            = builder.getNodeEx();
+			expr->seq               = builder.getSequence();
+			
+			return std::make_pair( std::string(""), SP_TCompiledExpr(expr) );
+		}
+		
+		/// LRU of compiled expressions keyed by expression text, shared by all workers. Failed compilations are not cached
+		class ExprCache {
+			private:
+				using TLruList = std::list< std::pair< std::string, SP_TCompiledExpr > >;
+				
+				std::mutex                                            _mutex;
+				TLruList                                              _lruList;
+				std::unordered_map< std::string, TLruList::iterator > _map;
+				size_t                                                _capacity;
+				
+				std::atomic< uint64_t > _hitCount  { 0 };
+				std::atomic< uint64_t > _missCount { 0 };
+				
+			public:
+				explicit ExprCache(const size_t capacity = 1024) : _capacity(capacity) {}
+				
+				std::pair< std::string, SP_TCompiledExpr > get(const std::string& code) {
+					{
+						std::lock_guard< std::mutex > lock(_mutex);
+						const auto it = _map.find(code);
+						if ( it != _map.end() ) {
+							_lruList.splice(_lruList.begin(), _lruList, it->second);
+							_hitCount++;
+							return std::make_pair( std::string(""), it->second->second );
+						}
+					}
+					
+					_missCount++;
+					const auto rec = compileExpr(code);
+					if ( !rec.second )
+						return rec;
+					
+					std::lock_guard< std::mutex > lock(_mutex);
+					if ( _map.find(code) != _map.end() )
+						return rec;
+					
+					_lruList.emplace_front(code, rec.second);
+					_map[ code ] = _lruList.begin();
+					if ( _lruList.size() > _capacity ) {
+						_map.erase(_lruList.back().first);
+						_lruList.pop_back();
+					}
+					
+					return rec;
+				}
+				
+				uint64_t getHitCount () const { return _hitCount; }
+				uint64_t getMissCount() const { return _missCount; }
+				size_t getSize() {
+					std::lock_guard< std::mutex > lock(_mutex);
+					return _lruList.size();
+				}
+				
+				static ExprCache& global() {
+					static ExprCache cache;
+					return cache;
+				}
+		};
+		
+		/// Prepared expressions of API clients, handles are per connection and dropped when it closes
+		class PreparedExprMgr {
+			public:
+				struct TPrepared {
+					SP_TCompiledExpr expr;
+					TDumpLimits      limits;
+				};
+				using SP_TPrepared = std::shared_ptr< const TPrepared >;
+				
+				static constexpr size_t MaxHandlesPerClient = 4096;
+				
+			private:
+				struct TClientHandles {
+					uint32_t                                       nextHandle = 1;
+					std::unordered_map< uint32_t, SP_TPrepared > handleMap;
+				};
+				
+				std::mutex                                     _mutex;
+				std::unordered_map< uint64_t, TClientHandles > _clientMap;
+				
+			public:
+				/// 0 if the client has too many handles
+				uint32_t add(const uint64_t clientID, SP_TPrepared prepared) {
+					std::lock_guard< std::mutex > lg(_mutex);
+					
+					auto& client = _clientMap[ clientID ];
+					if ( client.handleMap.size() >= MaxHandlesPerClient )
+						return 0;
+					
+					const uint32_t handle = client.nextHandle++;
+					client.handleMap[ handle ] = prepared;
+					return handle;
+				}
+				SP_TPrepared get(const uint64_t clientID, const uint32_t handle) {
+					std::lock_guard< std::mutex > lg(_mutex);
+					
+					const auto itClient = _clientMap.find(clientID);
+					if ( itClient == _clientMap.end() )
+						return nullptr;
+					
+					const auto it = itClient->second.handleMap.find(handle);
+					if ( it == itClient->second.handleMap.end() )
+						return nullptr;
+					
+					return it->second;
+				}
+				bool release(const uint64_t clientID, const uint32_t handle) {
+					std::lock_guard< std::mutex > lg(_mutex);
+					
+					const auto itClient = _clientMap.find(clientID);
+					if ( itClient == _clientMap.end() )
+						return false;
+					
+					return itClient->second.handleMap.erase(handle) != 0;
+				}
+				void releaseClient(const uint64_t clientID) {
+					std::lock_guard< std::mutex > lg(_mutex);
+					
+					_clientMap.erase(clientID);
+				}
+		};
+		using SP_PreparedExprMgr = std::shared_ptr< PreparedExprMgr >;
+		
+		std::string resolveAddress(uint64_t& address, const TAddressProgram& program, SP_MemorySource memSrc, const uint64_t baseAddress) {
+			std::string errorText = "";
+			program.run(address, baseAddress, [&](const uint64_t address, uint64_t& value) {
+				if ( const uint8_t* pView = memSrc->view(address, 8) ) {
+					memcpy(&value, pView, 8);
+					return true;
+				}
+				
+				auto memRec = memSrc->readMemory(address, 8);
+				errorText = memRec.first;
+				if ( errorText.length() )
+					return false;
+				
+				memcpy(&value, &(*memRec.second)[0], 8);
+				return true;
+			});
+			
+			return errorText;
+		}
+		
+		/// Longer sequences fail instead of being cut silently
+		const uint64_t MaxSequenceItems = 65536;
+		
+		/// where/sum/min/max: one scalar field of all elements is gathered into a dense column (int64_t, uint64_t or double),
+		/// so the compare and reduce loops run branch free over contiguous memory and the compiler can vectorize them
+		class SeqColumn {
+			private:
+				template< class T, class TValue >
+				static void _gatherAs(std::vector< T >& column, const std::vector< const uint8_t* >& pointerList, const TSeqField& field) {
+					const uint64_t mask = ( field.bits >= 64 ) ? ~0ull : ( ( 1ull << field.bits ) - 1 );
+					
+					column.resize(pointerList.size());
+					for(size_t i = 0; i != pointerList.size(); i++) {
+						TValue value;
+						memcpy(&value, pointerList[i], sizeof(value));
+						column[i] = field.bits ?
+							static_cast< T >( ( static_cast< uint64_t >( value ) >> field.shift ) & mask ) :
+							static_cast< T >( value );
+					}
+				}
+				template< class T >
+				static void _gather(std::vector< T >& column, const std::vector< const uint8_t* >& pointerList, const TSeqField& field) {
+					using ATF::Reflect::EnumScalarKind;
+					
+					switch( field.eScalarKind ) {
+						case EnumScalarKind::Int8   :
+						case EnumScalarKind::Char   : _gatherAs< T, int8_t   >(column, pointerList, field); break;
+						case EnumScalarKind::Int16  : _gatherAs< T, int16_t  >(column, pointerList, field); break;
+						case EnumScalarKind::Int32  : _gatherAs< T, int32_t  >(column, pointerList, field); break;
+						case EnumScalarKind::Int64  : _gatherAs< T, int64_t  >(column, pointerList, field); break;
+						case EnumScalarKind::Bool   :
+						case EnumScalarKind::UInt8  : _gatherAs< T, uint8_t  >(column, pointerList, field); break;
+						case EnumScalarKind::UInt16 :
+						case EnumScalarKind::UChar16: _gatherAs< T, uint16_t >(column, pointerList, field); break;
+						case EnumScalarKind::UInt32 : _gatherAs< T, uint32_t >(column, pointerList, field); break;
+						case EnumScalarKind::UInt64 : _gatherAs< T, uint64_t >(column, pointerList, field); break;
+						case EnumScalarKind::Float32: _gatherAs< T, float    >(column, pointerList, field); break;
+						case EnumScalarKind::Float64: _gatherAs< T, double   >(column, pointerList, field); break;
+						default:
+							column.assign(pointerList.size(), 0);
+							break;
+					}
+				}
+				
+				template< class T >
+				static void _filter(const TSeqFilter& filter, const std::vector< const uint8_t* >& pointerList, std::vector< uint8_t >& keepList, const T value) {
+					std::vector< T > column;
+					_gather(column, pointerList, filter.field);
+					
+					const T* p     = column.data();
+					uint8_t* pKeep = keepList.data();
+					const size_t count = column.size();
+					switch( filter.eCompare ) {
+						case TSeqFilter::NonZero: for(size_t i = 0; i != count; i++) pKeep[i] &= static_cast< uint8_t >( p[i] != 0     ); break;
+						case TSeqFilter::Eq     : for(size_t i = 0; i != count; i++) pKeep[i] &= static_cast< uint8_t >( p[i] == value ); break;
+						case TSeqFilter::Ne     : for(size_t i = 0; i != count; i++) pKeep[i] &= static_cast< uint8_t >( p[i] != value ); break;
+						case TSeqFilter::Lt     : for(size_t i = 0; i != count; i++) pKeep[i] &= static_cast< uint8_t >( p[i] <  value ); break;
+						case TSeqFilter::Le     : for(size_t i = 0; i != count; i++) pKeep[i] &= static_cast< uint8_t >( p[i] <= value ); break;
+						case TSeqFilter::Gt     : for(size_t i = 0; i != count; i++) pKeep[i] &= static_cast< uint8_t >( p[i] >  value ); break;
+						case TSeqFilter::Ge     : for(size_t i = 0; i != count; i++) pKeep[i] &= static_cast< uint8_t >( p[i] >= value ); break;
+					}
+				}
+				
+				/// Integer sums wrap around in uint64_t (signed overflow is UB), the result is cast back to the column type
+				template< class T >
+				static T _sum(const std::vector< T >& column, const std::vector< uint8_t >& keepList) {
+					using TAccumulator = typename std::conditional< std::is_floating_point< T >::value, T, uint64_t >::type;
+					
+					const T*       p     = column.data();
+					const uint8_t* pKeep = keepList.data();
+					
+					TAccumulator total = 0;
+					for(size_t i = 0; i != column.size(); i++)
+						total += pKeep[i] ? static_cast< TAccumulator >( p[i] ) : static_cast< TAccumulator >( 0 );
+					return static_cast< T >( total );
+				}
+				/// Index of the first kept minimum (maximum), NaNs are skipped, npos if nothing is kept
+				template< class T >
+				static size_t _extreme(const std::vector< T >& column, const std::vector< uint8_t >& keepList, const bool isMax) {
+					const T*       p     = column.data();
+					const uint8_t* pKeep = keepList.data();
+					const size_t   count = column.size();
+					
+					/// p[i] != p[i] only for NaN, later NaNs never win a compare
+					size_t first = 0;
+					for(; ( first != count ) && ( !pKeep[first] || ( p[first] != p[first] ) ); first++) ;
+					if ( first == count )
+						return std::string::npos;
+					
+					T best = p[first];
+					if ( isMax ) {
+						for(size_t i = first; i != count; i++)
+							best = ( pKeep[i] && ( p[i] > best ) ) ? p[i] : best;
+					} else {
+						for(size_t i = first; i != count; i++)
+							best = ( pKeep[i] && ( p[i] < best ) ) ? p[i] : best;
+					}
+					
+					for(size_t i = first; i != count; i++)
+						if ( pKeep[i] && ( p[i] == best ) )
+							return i;
+					return std::string::npos;
+				}
+				template< class T >
+				static std::string _aggregate(const TSequence::EnumAggregate eAggregate, const TSeqField& field, const std::vector< const uint8_t* >& pointerList, const std::vector< uint8_t >& keepList, const ATF::Reflect::EnumScalarKind eSumKind, const bool dumpJson, const bool dumpMsgPack) {
+					using ATF::Reflect::StructDumper;
+					
+					std::vector< T > column;
+					_gather(column, pointerList, field);
+					
+					if ( eAggregate == TSequence::AggregateSum ) {
+						const T total = _sum(column, keepList);
+						return StructDumper::scalarToText(eSumKind, reinterpret_cast< const uint8_t* >( &total ), dumpJson, dumpMsgPack);
+					}
+					
+					const size_t index = _extreme(column, keepList, eAggregate == TSequence::AggregateMax);
+					if ( index == std::string::npos )
+						return dumpMsgPack ? std::string("\xC0", 1) : std::string("null");
+					
+					/// Bitfields print the extracted value, other fields their own bytes
+					if ( field.bits )
+						return StructDumper::scalarToText(eSumKind, reinterpret_cast< const uint8_t* >( &column[ index ] ), dumpJson, dumpMsgPack);
+					return StructDumper::scalarToText(field.eScalarKind, pointerList[ index ], dumpJson, dumpMsgPack);
+				}
+				
+			public:
+				/// where: clears keepList of the elements failing the condition
+				static void filter(const TSeqFilter& filter, const std::vector< const uint8_t* >& pointerList, std::vector< uint8_t >& keepList) {
+					switch( filter.field.column() ) {
+						case TSeqField::ColumnInt  : _filter< int64_t  >(filter, pointerList, keepList, filter.iValue); break;
+						case TSeqField::ColumnUInt : _filter< uint64_t >(filter, pointerList, keepList, filter.uValue); break;
+						case TSeqField::ColumnFloat: _filter< double   >(filter, pointerList, keepList, filter.fValue); break;
+					}
+				}
+				/// sum/min/max of the kept elements as a dumped scalar, sums are int64/uint64/float64 by the field
+				static std::string aggregate(const TSequence::EnumAggregate eAggregate, const TSeqField& field, const std::vector< const uint8_t* >& pointerList, const std::vector< uint8_t >& keepList, const bool dumpJson, const bool dumpMsgPack) {
+					using ATF::Reflect::EnumScalarKind;
+					
+					switch( field.column() ) {
+						case TSeqField::ColumnInt  : return _aggregate< int64_t  >(eAggregate, field, pointerList, keepList, EnumScalarKind::Int64  , dumpJson, dumpMsgPack);
+						case TSeqField::ColumnUInt : return _aggregate< uint64_t >(eAggregate, field, pointerList, keepList, EnumScalarKind::UInt64 , dumpJson, dumpMsgPack);
+						case TSeqField::ColumnFloat: return _aggregate< double   >(eAggregate, field, pointerList, keepList, EnumScalarKind::Float64, dumpJson, dumpMsgPack);
+					}
+					return "";
+				}
+		};
+		
+		/// Collects the elements of each(...)/std::*/arrays next to the reader, applies where/select and dumps them as one array
+		/// (std::map elements as [key, value]) or returns only the count/sum/min/max.
+		/// Node walks read every node once with the link pointers and the bytes of its element that are used (read-ahead), so elements need no second read.
+		/// Arrays and std::vector elements are one contiguous read, std::map nodes are read level by level with one readMemoryList per tree level
+		std::string processSequence(std::string& outValue, const TCompiledExpr& expr, SP_MemorySource memSrc, const uint64_t baseAddress, const bool dumpJson, const bool dumpMsgPack, const TDumpLimits& limits) {
+			using namespace ATF::Reflect;
+			
+			const auto& seq = expr.seq;
+			if ( limits.pointerDepth )
+				return "ptrDepth is not supported for each/std containers";
+			
+			uint64_t address = 0;
+			const auto errorText = resolveAddress(address, expr.program, memSrc, baseAddress);
+			if ( errorText.length() )
+				return errorText;
+			
+			const auto& nodeEx = expr.nodeEx;
+			const auto elementNode = nodeEx.getNodeView(seq.elementNode.id);
+			const auto valueNode   = nodeEx.getNodeView(seq.valueNode.id);
+			const auto itemNode    = nodeEx.getNodeView(seq.itemNode.id);
+			const bool isMap       = seq.eKind == TSequence::StdMap;
+			const bool isDump      = seq.eAggregate == TSequence::AggregateNone;
+			
+			/// Layout of the output like StructDumper arrays: scalar items inline, others one per line
+			const bool isElementInline = !isMap && ( itemNode.type() == EnumNodeType::TypeScalar );
+			const bool isPairInline    = isMap && ( elementNode.type() == EnumNodeType::TypeScalar ) && ( valueNode.type() == EnumNodeType::TypeScalar );
+			const std::string GAP      = TStructDumperOptions{}.gap;
+			
+			StructDumper sd({ dumpJson, ( isMap && !isPairInline ) ? 3u : 2u, nullptr, dumpMsgPack, limits.maxDepth, limits.maxArrayElements, limits.fields.c_str(), }, nodeEx);
+			
+			/// Dumped parts of an element at element address + offset: the element, or key and mapped value of std::map
+			struct TPart {
+				std::shared_ptr< const DumpPlan > plan;
+				uint64_t                          offset = 0;
+			};
+			std::vector< TPart > partList;
+			if ( isDump )
+				partList.push_back({ sd.getPlan(itemNode), seq.itemOffset });
+			if ( isDump && isMap )
+				partList.push_back({ sd.getPlan(valueNode), seq.secondOffset });
+			
+			/// Bytes of an element the parts and the where/sum/min/max fields read, relative to the element address
+			uint64_t spanBegin = ~0ull;
+			uint64_t spanEnd   = 0;
+			const auto spanAdd = [&](const uint64_t begin, const uint64_t end) {
+				if ( begin == end )
+					return;
+				
+				spanBegin = std::min(spanBegin, begin);
+				spanEnd   = std::max(spanEnd  , end  );
+			};
+			for(const auto& part : partList) {
+				if ( part.plan->errorHas() )
+					return part.plan->errorGetFirst();
+				
+				spanAdd(part.offset + part.plan->dataBegin, part.offset + part.plan->dataEnd);
+			}
+			for(const auto& filter : seq.filterList)
+				spanAdd(filter.field.offset, filter.field.offset + scalarKindSize(filter.field.eScalarKind));
+			if ( !isDump && ( seq.eAggregate != TSequence::AggregateCount ) )
+				spanAdd(seq.aggregateField.offset, seq.aggregateField.offset + scalarKindSize(seq.aggregateField.eScalarKind));
+			if ( spanBegin > spanEnd )
+				spanBegin = spanEnd = 0;
+			
+			/// pData points to byte spanBegin of the element
+			struct TElement {
+				uint64_t       address = 0;
+				const uint8_t* pData   = nullptr;
+			};
+			std::vector< TElement > elementList;
+			std::vector< std::shared_ptr< std::vector< uint8_t > > > blockList;
+			
+			static const uint8_t noData = 0;
+			const auto readSpan = [&](const uint64_t address, const uint64_t size, const uint8_t*& pData) -> std::string {
+				pData = &noData;
+				if ( !size )
+					return "";
+				
+				if ( const uint8_t* pView = memSrc->view(address, size) ) {
+					pData = pView;
+					return "";
+				}
+				
+				auto memRec = memSrc->readMemory(address, size);
+				if ( memRec.first.length() )
+					return memRec.first;
+				
+				blockList.push_back(memRec.second);
+				pData = &(*memRec.second)[0];
+				return "";
+			};
+			const auto readPointer = [&](const uint64_t address, uint64_t& value) -> std::string {
+				const uint8_t* pData = nullptr;
+				const auto error = readSpan(address, 8, pData);
+				if ( !error.length() )
+					memcpy(&value, pData, 8);
+				return error;
+			};
+			const auto tooLong = [&]() {
+				return "Sequence has more than " + std::to_string(MaxSequenceItems) + " items";
+			};
+			/// Arrays and std::vector, all elements with one read
+			const auto readContiguous = [&](const uint64_t first, const uint64_t count) -> std::string {
+				if ( count > MaxSequenceItems )
+					return tooLong();
+				
+				const uint64_t size = elementNode.size();
+				const uint8_t* pData = nullptr;
+				const auto error = readSpan(first + spanBegin, ( count && ( spanBegin < spanEnd ) ) ? size * ( count - 1 ) + spanEnd - spanBegin : 0, pData);
+				if ( error.length() )
+					return error;
+				
+				for(uint64_t i = 0; i != count; i++)
+					elementList.push_back({ first + size * i, pData + ( ( spanBegin < spanEnd ) ? size * i : 0 ) });
+				return "";
+			};
+			
+			/// Linked nodes until null, endNode or a node seen before (circular lists), element at node + valueOffset
+			const auto walk = [&](uint64_t node, const uint64_t endNode, const uint64_t linkOffset, const uint64_t valueOffset) -> std::string {
+				const uint64_t readBegin = std::min(linkOffset, valueOffset + spanBegin);
+				const uint64_t readEnd   = std::max(linkOffset + 8, valueOffset + spanEnd);
+				
+				std::unordered_set< uint64_t > visitedSet;
+				while( node && ( node != endNode ) && visitedSet.insert(node).second ) {
+					if ( elementList.size() >= MaxSequenceItems )
+						return tooLong();
+					
+					const uint8_t* pNode = nullptr;
+					const auto error = readSpan(node + readBegin, readEnd - readBegin, pNode);
+					if ( error.length() )
+						return error;
+					
+					elementList.push_back({ node + valueOffset, pNode + ( valueOffset + spanBegin - readBegin ) });
+					memcpy(&node, pNode + ( linkOffset - readBegin ), 8);
+				}
+				return "";
+			};
+			
+			std::string error = "";
+			switch( seq.eKind ) {
+				case TSequence::Each:
+					error = walk(address, 0, seq.linkOffset, 0);
+					break;
+				
+				case TSequence::StdList: {
+					uint64_t head  = 0;
+					uint64_t first = 0;
+					error = readPointer(address + MsvcStdLayout::ContainerHead, head);
+					if ( !error.length() )
+						error = readPointer(head + MsvcStdLayout::ListNodeNext, first);
+					if ( !error.length() )
+						error = walk(first, head, MsvcStdLayout::ListNodeNext, MsvcStdLayout::ListNodeValue);
+				}
+				break;
+				
+				case TSequence::StdVector: {
+					uint64_t first = 0;
+					uint64_t last  = 0;
+					error = readPointer(address + MsvcStdLayout::VectorFirst, first);
+					if ( !error.length() )
+						error = readPointer(address + MsvcStdLayout::VectorLast, last);
+					if ( error.length() )
+						break;
+					
+					const uint64_t size = elementNode.size();
+					if ( ( last < first ) || ( ( last - first ) % size ) || ( ( last - first ) > Builder::MaxSliceSize ) ) {
+						error = "Invalid std::vector (first/last)";
+						break;
+					}
 					
-					SIZE_T numberOfBytesRead = 0;
-					const auto rmStatus = WinError::checkBool("ReadProcessMemory", 
-						::ReadProcessMemory( _process->getHandle(), (LPCVOID)address, (LPVOID)&((*mem)[0]), (SIZE_T)mem->size(), (SIZE_T*)&numberOfBytesRead ) );
+					error = readContiguous(first, ( last - first ) / size);
+				}
+				break;
+				
+				case TSequence::Array:
+					error = readContiguous(address, seq.arrayCount);
+					break;
+				
+				case TSequence::StdMap: {
+					uint64_t head  = 0;
+					uint64_t count = 0;
+					uint64_t root  = 0;
+					error = readPointer(address + MsvcStdLayout::ContainerHead, head);
+					if ( !error.length() )
+						error = readPointer(address + MsvcStdLayout::ContainerSize, count);
+					if ( !error.length() )
+						error = readPointer(head + MsvcStdLayout::TreeNodeParent, root);
+					if ( error.length() )
+						break;
 					
-					if ( rmStatus.fail() )
-						return retFalse( rmStatus.getErrorText() );
+					if ( count > MaxSequenceItems ) {
+						error = tooLong();
+						break;
+					}
 					
-					if ( mem->size() != numberOfBytesRead )
-						return retFalse("Only part of a ReadProcessMemory or WriteProcessMemory request was completed");
+					/// Breadth-first, every level of the tree is one readMemoryList. Nil leaves point to the head node
+					const uint64_t readEnd = std::max(MsvcStdLayout::TreeNodeRight + 8, seq.valueOffset + spanEnd);
+					struct TTreeNode {
+						uint64_t       left  = 0;
+						uint64_t       right = 0;
+						const uint8_t* pData = nullptr;
+					};
+					std::unordered_map< uint64_t, TTreeNode > treeNodeMap;
 					
-					return std::make_pair( std::string(""), mem );
+					std::vector< uint64_t > levelList;
+					if ( root && ( root != head ) )
+						levelList.push_back(root);
+					while( levelList.size() && !error.length() ) {
+						if ( treeNodeMap.size() + levelList.size() > count ) {
+							error = "Invalid std::map (more nodes than _Mysize)";
+							break;
+						}
+						
+						std::vector< const uint8_t* > viewList;
+						std::vector< TMemoryRead >    readList;
+						for(const auto node : levelList) {
+							const uint8_t* pView = memSrc->view(node, readEnd);
+							viewList.push_back(pView);
+							if ( !pView )
+								readList.push_back({ node, std::vector< uint8_t >( readEnd ), false });
+						}
+						if ( readList.size() )
+							memSrc->readMemoryList(readList);
+						
+						std::vector< uint64_t > nextLevelList;
+						for(size_t i = 0, r = 0; i != levelList.size(); i++) {
+							const uint8_t* pNode = viewList[i];
+							if ( !pNode ) {
+								auto& read = readList[ r++ ];
+								if ( !read.ok ) {
+									error = "Invalid std::map node " + ATF::Reflect::StructDumper::ptrToHex(read.address);
+									break;
+								}
+								
+								blockList.push_back( std::make_shared< std::vector< uint8_t > >( std::move(read.data) ) );
+								pNode = &(*blockList.back())[0];
+							}
+							
+							TTreeNode treeNode;
+							memcpy(&treeNode.left , pNode + MsvcStdLayout::TreeNodeLeft , 8);
+							memcpy(&treeNode.right, pNode + MsvcStdLayout::TreeNodeRight, 8);
+							treeNode.pData = pNode + seq.valueOffset + spanBegin;
+							treeNodeMap[ levelList[i] ] = treeNode;
+							
+							for(const auto child : { treeNode.left, treeNode.right })
+								if ( child && ( child != head ) && !treeNodeMap.count(child) )
+									nextLevelList.push_back(child);
+						}
+						
+						levelList.swap(nextLevelList);
+					}
+					if ( error.length() )
+						break;
+					
+					/// In order (by key)
+					std::vector< uint64_t > stack;
+					for(uint64_t node = root; stack.size() || ( treeNodeMap.count(node) ); ) {
+						if ( treeNodeMap.count(node) ) {
+							stack.push_back(node);
+							node = treeNodeMap[ node ].left;
+							continue;
+						}
+						
+						node = stack.back();
+						stack.pop_back();
+						
+						const auto& treeNode = treeNodeMap[ node ];
+						elementList.push_back({ node + seq.valueOffset, treeNode.pData });
+						if ( elementList.size() > treeNodeMap.size() ) {
+							error = "Invalid std::map (cycle)";
+							break;
+						}
+						node = treeNode.right;
+					}
 				}
-		};
-		using SP_WinReadProcessMemory = std::shared_ptr< WinReadProcessMemory >;
-
-		std::string processStruct(std::string& outValue, const std::string& code, SP_WinReadProcessMemory wrpm, const uint64_t baseAddress, const bool dumpJson = false) {
-			const auto tokRec = Lexer::getTokens(code);
-			if ( tokRec.first.errorHas() )
-				return tokRec.first.errorGetFirst();
-
-			const auto cmdRec = Parser::parse(tokRec.second);
-			if ( cmdRec.first.errorHas() )
-				return cmdRec.first.errorGetFirst();
+				break;
+				
+				default:
+					error = "Internal error, invalid sequence";
+					break;
+			}
+			if ( error.length() )
+				return error;
 			
-			Builder builder(cmdRec.second);
-			if ( builder.errorHas() )
-				return builder.errorGetFirst();
+			/// where, then count/sum/min/max over the kept elements
+			std::vector< uint8_t > keepList( elementList.size(), 1 );
+			const auto fieldPointerList = [&](const TSeqField& field) {
+				std::vector< const uint8_t* > pointerList( elementList.size() );
+				for(size_t i = 0; i != elementList.size(); i++)
+					pointerList[i] = elementList[i].pData + ( field.offset - spanBegin );
+				return pointerList;
+			};
+			for(const auto& filter : seq.filterList)
+				SeqColumn::filter(filter, fieldPointerList(filter.field), keepList);
 			
-			const auto state = builder.getState();
-			if ( !state.check({ TState::LValue, TState::Address }) )
-				return "Invalid type state, expected l-value/address";
+			if ( seq.eAggregate == TSequence::AggregateCount ) {
+				uint64_t count = 0;
+				for(const auto keep : keepList)
+					count += keep;
+				
+				outValue = StructDumper::scalarToText(EnumScalarKind::UInt64, reinterpret_cast< const uint8_t* >( &count ), dumpJson, dumpMsgPack);
+				return "";
+			}
+			if ( !isDump ) {
+				outValue = SeqColumn::aggregate(seq.eAggregate, seq.aggregateField, fieldPointerList(seq.aggregateField), keepList, dumpJson, dumpMsgPack);
+				return "";
+			}
 			
-			std::string errorText = "";
-			const uint64_t address = state.addrAcc.calcAddress( baseAddress, [&](const uint64_t address) {
-				uint64_t nextAddress = 0;
+			if ( seq.filterList.size() ) {
+				size_t keepCount = 0;
+				for(size_t i = 0; i != elementList.size(); i++)
+					if ( keepList[i] )
+						elementList[ keepCount++ ] = elementList[i];
+				elementList.resize(keepCount);
+			}
+			
+			/// Output
+			outValue.clear();
+			const auto appendPart = [&](const TElement& element, const TPart& part) {
+				const uint8_t* pPart = ( part.plan->dataBegin == part.plan->dataEnd ) ? &noData : element.pData + ( part.offset + part.plan->dataBegin - spanBegin );
+				StructDumper::runPlan(*part.plan, pPart, outValue, part.plan->dataBegin);
+			};
+			
+			if ( dumpMsgPack ) {
+				StructDumper::msgPackArrayHeader(outValue, static_cast< uint32_t >( elementList.size() ));
+				for(const auto& element : elementList) {
+					if ( isMap )
+						StructDumper::msgPackArrayHeader(outValue, 2);
+					for(const auto& part : partList)
+						appendPart(element, part);
+				}
+				return "";
+			}
+			
+			outValue += isElementInline ? "[" : "[\n";
+			for(size_t i = 0; i != elementList.size(); i++) {
+				if ( !isElementInline )
+					outValue += GAP;
 				
-				auto memRec = wrpm->readMemory(address, 8);
-				errorText = memRec.first;
-				if ( errorText.length() )
-					return std::make_pair( false, nextAddress );
+				if ( isMap ) {
+					outValue += isPairInline ? "[" : "[\n" + GAP + GAP;
+					appendPart(elementList[i], partList[0]);
+					outValue += isPairInline ? ", " : ", \n" + GAP + GAP;
+					appendPart(elementList[i], partList[1]);
+					outValue += isPairInline ? "]" : "\n" + GAP + "]";
+				} else {
+					appendPart(elementList[i], partList[0]);
+				}
 				
-				nextAddress = *( (uint64_t*)&(*memRec.second)[0] );
+				if ( i + 1 != elementList.size() )
+					outValue += ", ";
 				
-				return std::make_pair( true, nextAddress );
-			});
+				if ( !isElementInline )
+					outValue += "\n";
+			}
+			outValue += "]";
 			
+			return "";
+		}
+		
+		std::string processExpr(std::string& outValue, const TCompiledExpr& expr, SP_MemorySource memSrc, const uint64_t baseAddress, const bool dumpJson = false, const bool dumpMsgPack = false, const TDumpLimits& limits = {}) {
+			if ( expr.seq.eKind != TSequence::None )
+				return processSequence(outValue, expr, memSrc, baseAddress, dumpJson, dumpMsgPack, limits);
+			
+			const auto& program = expr.program;
+			
+			uint64_t address = 0;
+			const auto errorText = resolveAddress(address, program, memSrc, baseAddress);
 			if ( errorText.length() )
 				return errorText;
 
-			if ( state.eType == TState::Address ) {
-				outValue = ATF::Reflect::StructDumper::ptrToHex(address, dumpJson);
-			}
-			
-			if ( state.eType == TState::LValue ) {
-				auto memRec = wrpm->readMemory(address, state.nodeAcc.back().size);
-				if ( memRec.first.length() )
-					return memRec.first;
+			if ( program.isAddress ) {
+				outValue = dumpMsgPack ?
+					ATF::Reflect::StructDumper::ptrToMsgPack(address) :
+					ATF::Reflect::StructDumper::ptrToHex(address, dumpJson);
+			} else {
+				if ( limits.pointerDepth ) {
+					const auto& nodeEx = expr.nodeEx;
+					ATF::Reflect::StructDumper sd({ dumpJson, 1, nullptr, dumpMsgPack, limits.maxDepth, limits.maxArrayElements, limits.fields.c_str(), }, nodeEx);
+					
+					/// View into nodeEx/the static data
+					const auto node = nodeEx.getNodeView(program.nodeID);
+					
+					outValue.clear();
+					sd.dumpGraph(node, address, [&](std::vector< TMemoryRead >& readList) {
+						memSrc->readMemoryList(readList);
+					}, outValue, limits.pointerDepth);
+					
+					if ( sd.errorHas() )
+						return sd.errorGetFirst();
+					
+					return "";
+				}
 				
-				auto dumpRec = ATF::Reflect::dumpStruct(state.nodeAcc.back(), &(*memRec.second)[0], { dumpJson, 1, }, builder.getNodeEx());
-				if ( dumpRec.first.errorHas() )
-					return dumpRec.first.errorGetFirst();
+				const auto plan = expr.getPlan(dumpJson, dumpMsgPack, limits);
+				if ( plan->errorHas() )
+					return plan->errorGetFirst();
+				
+				/// Only the bytes the plan reads, projections and limits skip the rest of the object
+				uint8_t noData = 0;
+				const uint8_t* pData = &noData;
+				std::shared_ptr< std::vector< uint8_t > > mem;
+				if ( const uint8_t* pView = memSrc->view(address + plan->dataBegin, plan->dataEnd - plan->dataBegin) ) {
+					pData = pView;
+				} else if ( plan->dataBegin < plan->dataEnd ) {
+					auto memRec = memSrc->readMemory(address + plan->dataBegin, plan->dataEnd - plan->dataBegin);
+					if ( memRec.first.length() )
+						return memRec.first;
+					
+					mem   = memRec.second;
+					pData = &(*mem)[0];
+				}
 				
-				outValue = dumpRec.second;
+				outValue.clear();
+				ATF::Reflect::StructDumper::runPlan(*plan, pData, outValue, plan->dataBegin);
 			}
 
 			return "";
 		}
+		std::string processStruct(std::string& outValue, const std::string& code, SP_MemorySource memSrc, const uint64_t baseAddress, const bool dumpJson = false, const bool dumpMsgPack = false, const TDumpLimits& limits = {}) {
+			const auto exprRec = ExprCache::global().get(code);
+			if ( !exprRec.second )
+				return exprRec.first;
+			
+			return processExpr(outValue, *exprRec.second, memSrc, baseAddress, dumpJson, dumpMsgPack, limits);
+		}
+		
+		/// One expression of processBatch, items with error set (e.g. compile errors) are skipped
+		struct TBatchItem {
+			SP_TCompiledExpr expr;
+			TDumpLimits      limits;
+			std::string      error;
+			std::string      out;
+		};
+		
+		/// Ranges closer than this are read as one block
+		const uint64_t BatchCoalesceGap = 256;
+		const uint32_t MaxBatchItems    = 4096;
+		
+		/// Resolves all addresses first, then reads the byte ranges of all dumps merged into the fewest blocks
+		/// (overlapping, adjacent or within BatchCoalesceGap) in one vectored read and runs every plan on its slice of a block.
+		/// A failed block falls back to reading its ranges one by one, so one bad address does not fail its neighbours
+		void processBatch(std::vector< TBatchItem >& itemList, SP_MemorySource memSrc, const uint64_t baseAddress, const bool dumpJson, const bool dumpMsgPack) {
+			struct TRange {
+				uint64_t                                        begin     = 0;
+				uint64_t                                        end       = 0;
+				size_t                                          itemIndex = 0;
+				std::shared_ptr< const ATF::Reflect::DumpPlan > plan;
+			};
+			std::vector< TRange > rangeList;
+			
+			for(size_t i = 0; i != itemList.size(); i++) {
+				auto& item = itemList[i];
+				if ( item.error.length() )
+					continue;
+				
+				/// Graph dumps read level by level and sequences walk their nodes, no fixed range
+				if ( item.limits.pointerDepth || ( item.expr->seq.eKind != TSequence::None ) ) {
+					item.error = processExpr(item.out, *item.expr, memSrc, baseAddress, dumpJson, dumpMsgPack, item.limits);
+					continue;
+				}
+				
+				const auto& program = item.expr->program;
+				
+				uint64_t address = 0;
+				item.error = resolveAddress(address, program, memSrc, baseAddress);
+				if ( item.error.length() )
+					continue;
+				
+				if ( program.isAddress ) {
+					item.out = dumpMsgPack ?
+						ATF::Reflect::StructDumper::ptrToMsgPack(address) :
+						ATF::Reflect::StructDumper::ptrToHex(address, dumpJson);
+					continue;
+				}
+				
+				TRange range;
+				range.plan = item.expr->getPlan(dumpJson, dumpMsgPack, item.limits);
+				if ( range.plan->errorHas() ) {
+					item.error = range.plan->errorGetFirst();
+					continue;
+				}
+				
+				range.begin     = address + range.plan->dataBegin;
+				range.end       = address + range.plan->dataEnd;
+				range.itemIndex = i;
+				rangeList.push_back(range);
+			}
+			
+			std::sort(rangeList.begin(), rangeList.end(), [](const TRange& l, const TRange& r) { return l.begin < r.begin; });
+			
+			const auto runRange = [&](const TRange& range, const uint8_t* pData) {
+				auto& item = itemList[ range.itemIndex ];
+				item.out.clear();
+				ATF::Reflect::StructDumper::runPlan(*range.plan, pData, item.out, range.plan->dataBegin);
+			};
+			const auto readRange = [&](const TRange& range) {
+				uint8_t noData = 0;
+				if ( range.begin == range.end ) {
+					runRange(range, &noData);
+					return;
+				}
+				
+				auto memRec = memSrc->readMemory(range.begin, range.end - range.begin);
+				if ( memRec.first.length() ) {
+					itemList[ range.itemIndex ].error = memRec.first;
+					return;
+				}
+				
+				runRange(range, &(*memRec.second)[0]);
+			};
+			
+			/// Block i covers rangeList[ blockFirstList[i], blockFirstList[i + 1] ), all blocks are read with one readMemoryList
+			/// (blocks the source can view() directly are not read)
+			std::vector< size_t >         blockFirstList;
+			std::vector< const uint8_t* > blockViewList;
+			std::vector< TMemoryRead >    readList;
+			for(size_t first = 0; first != rangeList.size(); ) {
+				uint64_t blockEnd = rangeList[ first ].end;
+				
+				/// Blocks do not cross the end of the readable span (region map), a gap between regions would fail the whole block
+				const uint64_t readableEnd = memSrc->getReadableEnd( rangeList[ first ].begin );
+				
+				size_t last = first + 1;
+				for(; last != rangeList.size(); last++) {
+					if ( ( rangeList[ last ].begin > blockEnd + BatchCoalesceGap ) || ( rangeList[ last ].end > readableEnd ) )
+						break;
+					
+					blockEnd = std::max(blockEnd, rangeList[ last ].end);
+				}
+				
+				const uint64_t blockBegin = rangeList[ first ].begin;
+				const uint8_t* pView = memSrc->view(blockBegin, blockEnd - blockBegin);
+				blockFirstList.push_back(first);
+				blockViewList.push_back(pView);
+				readList.push_back({ blockBegin, std::vector< uint8_t >( pView ? 0 : blockEnd - blockBegin ), false });
+				
+				first = last;
+			}
+			blockFirstList.push_back( rangeList.size() );
+			
+			memSrc->readMemoryList(readList);
+			
+			for(size_t b = 0; b != readList.size(); b++) {
+				const auto& read = readList[b];
+				const uint8_t* pBlock = blockViewList[b] ? blockViewList[b] : ( read.data.empty() ? nullptr : &read.data[0] );
+				for(size_t i = blockFirstList[b]; i != blockFirstList[b + 1]; i++) {
+					if ( !read.ok ) {
+						readRange(rangeList[i]);
+						continue;
+					}
+					
+					uint8_t noData = 0;
+					runRange(rangeList[i], pBlock ? pBlock + ( rangeList[i].begin - read.address ) : &noData);
+				}
+			}
+		}
 
 		
-		void apiWorker(TCPMessageServer::SP_TCPMessageServer tms, SP_WinReadProcessMemory wrpm, const uint64_t baseAddress) {
+		#if defined(_WIN32)
+		void apiWorker(TCPMessageServer::SP_TCPMessageServer tms, SP_MemorySource memSrc, const uint64_t baseAddress, SP_PreparedExprMgr preparedExprMgr) {
 			#pragma pack(push, 1)
 			struct TReadMemoryReq {
 				uint32_t cmdID;
@@ -902,13 +3325,64 @@ namespace ProcessMemoryReader {
 			};
 			#pragma pack(pop)
 			
-			const uint32_t CmdReqReadMemory = 1;
-			const uint32_t CmdResReadMemory = 2;
+			const uint32_t CmdReqReadMemory        = 1;
+			const uint32_t CmdResReadMemory        = 2;
+			
+			/// Response: u8 1 + MessagePack value, or u8 0 + error text
+			const uint32_t CmdReqReadMemoryMsgPack = 3;
+			const uint32_t CmdResReadMemoryMsgPack = 4;
+			
+			/// Response: MessagePack array of names, map keys of CmdResReadMemoryMsgPack index it
+			const uint32_t CmdReqNameTable         = 5;
+			const uint32_t CmdResNameTable         = 6;
+			
+			/// Response: JSON text (NUL terminated), expression/page cache and region map counters
+			const uint32_t CmdReqStats             = 7;
+			const uint32_t CmdResStats             = 8;
+			
+			/// Payload: code \0 [dump limits \0]. Response: u8 1 + u32 handle, or u8 0 + error text
+			const uint32_t CmdReqPrepare           = 9;
+			const uint32_t CmdResPrepare           = 10;
+			
+			/// Payload: u32 handle, u8 format (0 - JSON, 1 - MessagePack). Response: u8 1 + value, or u8 0 + error text
+			const uint32_t CmdReqExecute           = 11;
+			const uint32_t CmdResExecute           = 12;
+			
+			/// Payload: u32 handle. Response: u8 1 if the handle existed
+			const uint32_t CmdReqRelease           = 13;
+			const uint32_t CmdResRelease           = 14;
+			
+			/// Payload: u8 format (0 - JSON, 1 - MessagePack), u32 count, count items of
+			///   u8 0 + code \0 + dump limits \0 (may be empty), or u8 1 + u32 handle.
+			/// Response: u32 count, count results of u8 status (1 ok, 0 error) + u32 size + value or error text. At most MaxBatchItems items
+			const uint32_t CmdReqBatch             = 15;
+			const uint32_t CmdResBatch             = 16;
+			
+			/// Starts a new page cache snapshot. Response: u64 epoch
+			const uint32_t CmdReqAdvanceEpoch      = 17;
+			const uint32_t CmdResAdvanceEpoch      = 18;
+			
+			/// Read memory payload: code \0 [dump limits \0], limits see parseDumpLimits
+			const auto parseReadMemoryReq = [](const uint8_t* pData, const uint64_t dataSize, std::string& code, TDumpLimits& limits) {
+				const std::string payload((const char*)pData, dataSize);
+				code = payload.c_str();
+				
+				if ( code.length() + 1 >= payload.length() )
+					return std::string("");
+				
+				return parseDumpLimits(limits, payload.c_str() + code.length() + 1);
+			};
 			
+			std::string out;
 			while( true ) {
 				auto msgRec = tms->readMessage();
 				if ( msgRec.first ) {
 					auto msg = msgRec.second;
+					if ( msg.eType == TCPMessageServer::TClientRecord::Close ) {
+						preparedExprMgr->releaseClient(msg.clientID);
+						continue;
+					}
+					
 					if ( msg.messageData ) {
 						if ( sizeof(TReadMemoryReq) + 1 <= msg.messageData->size() ) {
 							auto dataRec = msg.messageData->getData();
@@ -917,11 +3391,13 @@ namespace ProcessMemoryReader {
 							const auto pHead = reinterpret_cast< const TReadMemoryReq* >(pData);
 							
 							if ( pHead->cmdID == CmdReqReadMemory ) {
-								std::string code_s((const char*)&pHead[1], dataSize - sizeof(TReadMemoryReq));
-								std::string code = code_s.c_str();
+								std::string code;
+								TDumpLimits limits;
+								auto error = parseReadMemoryReq((const uint8_t*)&pHead[1], dataSize - sizeof(TReadMemoryReq), code, limits);
 								{
-									std::string out = "";
-									const auto error = processStruct(out, code, wrpm, baseAddress, true);
+									out.clear();
+									if ( !error.length() )
+										error = processStruct(out, code, memSrc, baseAddress, true, false, limits);
 									if ( error.length() )
 										out = "#" + error;
 									
@@ -932,6 +3408,192 @@ namespace ProcessMemoryReader {
 								}
 								continue;
 							}
+							
+							if ( pHead->cmdID == CmdReqReadMemoryMsgPack ) {
+								std::string code;
+								TDumpLimits limits;
+								auto error = parseReadMemoryReq((const uint8_t*)&pHead[1], dataSize - sizeof(TReadMemoryReq), code, limits);
+								{
+									out.clear();
+									if ( !error.length() )
+										error = processStruct(out, code, memSrc, baseAddress, false, true, limits);
+									if ( error.length() )
+										out = error;
+									
+									auto msgRes = std::make_shared< TCPMessageServer::MessageData >();
+									msgRes->append( TReadMemoryReq{ CmdResReadMemoryMsgPack, pHead->rpcID } );
+									msgRes->append( (uint8_t)( error.length() ? 0 : 1 ) );
+									msgRes->append( (const uint8_t*)out.data(), out.length() );
+									tms->sendMessage( msg.clientID, msgRes );
+								}
+								continue;
+							}
+							
+							if ( pHead->cmdID == CmdReqPrepare ) {
+								std::string code;
+								auto prepared = std::make_shared< PreparedExprMgr::TPrepared >();
+								auto error = parseReadMemoryReq((const uint8_t*)&pHead[1], dataSize - sizeof(TReadMemoryReq), code, prepared->limits);
+								
+								uint32_t handle = 0;
+								if ( !error.length() ) {
+									const auto exprRec = ExprCache::global().get(code);
+									error = exprRec.first;
+									prepared->expr = exprRec.second;
+								}
+								if ( !error.length() ) {
+									handle = preparedExprMgr->add(msg.clientID, prepared);
+									if ( !handle )
+										error = "Too many prepared expressions";
+								}
+								
+								auto msgRes = std::make_shared< TCPMessageServer::MessageData >();
+								msgRes->append( TReadMemoryReq{ CmdResPrepare, pHead->rpcID } );
+								msgRes->append( (uint8_t)( error.length() ? 0 : 1 ) );
+								if ( error.length() )
+									msgRes->append( (const uint8_t*)error.data(), error.length() );
+								else
+									msgRes->append( handle );
+								tms->sendMessage( msg.clientID, msgRes );
+								continue;
+							}
+							
+							if ( ( pHead->cmdID == CmdReqExecute ) && ( sizeof(TReadMemoryReq) + 4 + 1 <= dataSize ) ) {
+								uint32_t handle = 0;
+								memcpy(&handle, &pHead[1], sizeof(handle));
+								const bool dumpMsgPack = ( (const uint8_t*)&pHead[1] )[ sizeof(handle) ] == 1;
+								
+								std::string error;
+								out.clear();
+								const auto prepared = preparedExprMgr->get(msg.clientID, handle);
+								if ( prepared )
+									error = processExpr(out, *prepared->expr, memSrc, baseAddress, !dumpMsgPack, dumpMsgPack, prepared->limits);
+								else
+									error = "Invalid handle";
+								if ( error.length() )
+									out = error;
+								
+								auto msgRes = std::make_shared< TCPMessageServer::MessageData >();
+								msgRes->append( TReadMemoryReq{ CmdResExecute, pHead->rpcID } );
+								msgRes->append( (uint8_t)( error.length() ? 0 : 1 ) );
+								msgRes->append( (const uint8_t*)out.data(), out.length() );
+								tms->sendMessage( msg.clientID, msgRes );
+								continue;
+							}
+							
+							if ( ( pHead->cmdID == CmdReqRelease ) && ( sizeof(TReadMemoryReq) + 4 <= dataSize ) ) {
+								uint32_t handle = 0;
+								memcpy(&handle, &pHead[1], sizeof(handle));
+								
+								auto msgRes = std::make_shared< TCPMessageServer::MessageData >();
+								msgRes->append( TReadMemoryReq{ CmdResRelease, pHead->rpcID } );
+								msgRes->append( (uint8_t)( preparedExprMgr->release(msg.clientID, handle) ? 1 : 0 ) );
+								tms->sendMessage( msg.clientID, msgRes );
+								continue;
+							}
+							
+							if ( ( pHead->cmdID == CmdReqBatch ) && ( sizeof(TReadMemoryReq) + 1 + 4 <= dataSize ) ) {
+								const uint8_t* p    = (const uint8_t*)&pHead[1];
+								const uint8_t* pEnd = pData + dataSize;
+								
+								const bool dumpMsgPack = *p++ == 1;
+								uint32_t count = 0;
+								memcpy(&count, p, sizeof(count));
+								p += sizeof(count);
+								count = std::min(count, MaxBatchItems);
+								
+								std::vector< TBatchItem > itemList;
+								for(uint32_t i = 0; ( i != count ) && ( p < pEnd ); i++) {
+									TBatchItem item;
+									const uint8_t kind = *p++;
+									if ( kind == 1 ) {
+										uint32_t handle = 0;
+										if ( p + sizeof(handle) > pEnd )
+											break;
+										
+										memcpy(&handle, p, sizeof(handle));
+										p += sizeof(handle);
+										
+										const auto prepared = preparedExprMgr->get(msg.clientID, handle);
+										if ( prepared ) {
+											item.expr   = prepared->expr;
+											item.limits = prepared->limits;
+										} else {
+											item.error = "Invalid handle";
+										}
+									} else {
+										const auto pCodeEnd = (const uint8_t*)memchr(p, 0, pEnd - p);
+										const auto pLimitsEnd = pCodeEnd ? (const uint8_t*)memchr(pCodeEnd + 1, 0, pEnd - pCodeEnd - 1) : nullptr;
+										if ( !pLimitsEnd )
+											break;
+										
+										const std::string code((const char*)p, pCodeEnd - p);
+										item.error = parseDumpLimits(item.limits, std::string((const char*)pCodeEnd + 1, pLimitsEnd - pCodeEnd - 1));
+										p = pLimitsEnd + 1;
+										
+										if ( !item.error.length() ) {
+											const auto exprRec = ExprCache::global().get(code);
+											item.error = exprRec.first;
+											item.expr  = exprRec.second;
+										}
+									}
+									itemList.push_back(std::move(item));
+								}
+								
+								/// Truncated payload, answer the missing items with errors
+								while( itemList.size() < count ) {
+									TBatchItem item;
+									item.error = "Invalid batch item";
+									itemList.push_back(std::move(item));
+								}
+								
+								processBatch(itemList, memSrc, baseAddress, !dumpMsgPack, dumpMsgPack);
+								
+								auto msgRes = std::make_shared< TCPMessageServer::MessageData >();
+								msgRes->append( TReadMemoryReq{ CmdResBatch, pHead->rpcID } );
+								msgRes->append( count );
+								for(const auto& item : itemList) {
+									const auto& value = item.error.length() ? item.error : item.out;
+									msgRes->append( (uint8_t)( item.error.length() ? 0 : 1 ) );
+									msgRes->append( (uint32_t)value.length() );
+									msgRes->append( (const uint8_t*)value.data(), value.length() );
+								}
+								tms->sendMessage( msg.clientID, msgRes );
+								continue;
+							}
+							
+							if ( pHead->cmdID == CmdReqStats ) {
+								auto& exprCache = ExprCache::global();
+								const auto stats = ATF::Reflect::stringFormat(
+									"{\"exprCacheHit\": ", exprCache.getHitCount(), ", \"exprCacheMiss\": ", exprCache.getMissCount(), ", \"exprCacheSize\": ", exprCache.getSize(),
+									", \"pageCacheHit\": ", memSrc->getPageHitCount(), ", \"pageCacheMiss\": ", memSrc->getPageMissCount(), ", \"epoch\": ", memSrc->getEpoch(),
+									", \"regionReject\": ", memSrc->getRegionRejectCount(), "}");
+								
+								auto msgRes = std::make_shared< TCPMessageServer::MessageData >();
+								msgRes->append( TReadMemoryReq{ CmdResStats, pHead->rpcID } );
+								msgRes->append( (const uint8_t*)stats.c_str(), stats.length() + 1 );
+								tms->sendMessage( msg.clientID, msgRes );
+								continue;
+							}
+							
+							if ( pHead->cmdID == CmdReqAdvanceEpoch ) {
+								const uint64_t epoch = memSrc->advanceEpoch();
+								
+								auto msgRes = std::make_shared< TCPMessageServer::MessageData >();
+								msgRes->append( TReadMemoryReq{ CmdResAdvanceEpoch, pHead->rpcID } );
+								msgRes->append( epoch );
+								tms->sendMessage( msg.clientID, msgRes );
+								continue;
+							}
+							
+							if ( pHead->cmdID == CmdReqNameTable ) {
+								const auto& nameTable = ATF::Reflect::StructDumper::msgPackNameTable();
+								
+								auto msgRes = std::make_shared< TCPMessageServer::MessageData >();
+								msgRes->append( TReadMemoryReq{ CmdResNameTable, pHead->rpcID } );
+								msgRes->append( (const uint8_t*)nameTable.data(), nameTable.length() );
+								tms->sendMessage( msg.clientID, msgRes );
+								continue;
+							}
 						}
 					}
 				}
@@ -939,14 +3601,35 @@ namespace ProcessMemoryReader {
 				Sleep(1);
 			}
 		}
+		#endif
 
 		template< class T >
 		void main(const T& conOptList) {
 			const auto processName = conOptList.get("target");
 			const bool dumpJson = conOptList.has("dumpJson");
+			
+			TDumpLimits limits;
+			{
+				std::string limitsText;
+				if ( conOptList.has("maxDepth") )
+					limitsText += "maxDepth=" + conOptList.get("maxDepth") + ";";
+				if ( conOptList.has("maxArray") )
+					limitsText += "maxArray=" + conOptList.get("maxArray") + ";";
+				if ( conOptList.has("fields") )
+					limitsText += "fields=" + conOptList.get("fields") + ";";
+				if ( conOptList.has("ptrDepth") )
+					limitsText += "ptrDepth=" + conOptList.get("ptrDepth") + ";";
+				
+				const auto error = parseDumpLimits(limits, limitsText);
+				if ( error.length() ) {
+					std::cout << error << "\n";
+					return;
+				}
+			}
 					
 			uint64_t baseAddress = 0x140000000;
-			if ( conOptList.has("baseAddress") ) {
+			const bool hasBaseAddress = conOptList.has("baseAddress");
+			if ( hasBaseAddress ) {
 				const auto rec = Builder::strToU64( conOptList.get("baseAddress") );
 				if ( rec.first ) {
 					std::cout << "Invalid baseAddress \n";
@@ -956,17 +3639,109 @@ namespace ProcessMemoryReader {
 				baseAddress = rec.second;
 			}
 					
-			if ( !processName.length() ) {
+			/// -target:<process name> or -pid:<process id>
+			uint64_t processId = 0;
+			if ( conOptList.has("pid") ) {
+				const auto rec = Builder::strToU64( conOptList.get("pid") );
+				if ( rec.first || !rec.second ) {
+					std::cout << "Invalid pid \n";
+					return;
+				}
+				
+				processId = rec.second;
+			}
+			
+			/// -snapshot:<file> serves all reads from a captured snapshot instead of a live process
+			const auto snapshotPath = conOptList.get("snapshot");
+			
+			if ( !processName.length() && !processId && !snapshotPath.length() ) {
 				std::cout << "Target process is not set\n";
 				return;
 			}
 
-			auto wrpm = std::make_shared< WinReadProcessMemory >( processName );
-			if ( wrpm->getErrorText().length() ) {
-				std::cout << wrpm->getErrorText() << "\n";
+			#if defined(_WIN32)
+				using TMemorySource = WinReadProcessMemory;
+				using TProcessId    = DWORD;
+			#elif defined(__linux__)
+				using TMemorySource = LinuxReadProcessMemory;
+				using TProcessId    = pid_t;
+			#endif
+			
+			SP_MemorySource memSrc;
+			if ( snapshotPath.length() ) {
+				auto snapshot = std::make_shared< SnapshotMemorySource >( snapshotPath );
+				if ( !hasBaseAddress )
+					baseAddress = snapshot->getBaseAddress();
+				
+				memSrc = snapshot;
+			} else {
+				memSrc = processId ?
+					std::make_shared< TMemorySource >( (TProcessId)processId ) :
+					std::make_shared< TMemorySource >( processName );
+			}
+			if ( memSrc->getErrorText().length() ) {
+				std::cout << memSrc->getErrorText() << "\n";
+				return;
+			}
+			
+			/// Live targets validate addresses against the region map, -regionCheck:0 turns it off
+			if ( !snapshotPath.length() && ( conOptList.get("regionCheck", "1") != "0" ) )
+				memSrc->setRegionCheck(true);
+			
+			/// -capture:<file> writes a snapshot of the target (num-workers readers) and exits
+			if ( conOptList.has("capture") ) {
+				const auto numThreadsRec = Builder::strToU64( conOptList.get("num-workers", "4") );
+				if ( numThreadsRec.first || !numThreadsRec.second || ( numThreadsRec.second > 32 ) ) {
+					std::cout << "Invalid num-workers ( must on [1;32] )\n";
+					return;
+				}
+				
+				const auto timeStart = std::chrono::steady_clock::now();
+				const auto error = captureSnapshot(conOptList.get("capture"), memSrc, baseAddress, (size_t)numThreadsRec.second);
+				const double sec = std::chrono::duration< double >( std::chrono::steady_clock::now() - timeStart ).count();
+				
+				if ( error.length() )
+					std::cout << error << "\n";
+				else
+					std::cout << ATF::Reflect::stringFormat("Snapshot '", conOptList.get("capture"), "' written, ", sec * 1000.0, " ms") << "\n";
 				return;
 			}
 			
+			/// -pageCache:epoch|consistent, -epochMs:N advances the snapshot by timer (0 - only by client / per stdin line).
+			/// API clients may never send CmdReqAdvanceEpoch, with -api-host the timer defaults to DefaultApiEpochMs
+			const uint64_t DefaultApiEpochMs = 100;
+			uint64_t epochMs = 0;
+			if ( conOptList.has("pageCache") ) {
+				const auto mode = conOptList.get("pageCache");
+				if ( mode == "epoch" ) {
+					memSrc->setCacheMode(MemorySource::CacheEpoch);
+				} else if ( mode == "consistent" ) {
+					memSrc->setCacheMode(MemorySource::CacheConsistent);
+				} else {
+					std::cout << "Invalid pageCache ( epoch, consistent )\n";
+					return;
+				}
+				
+				const auto epochMsRec = Builder::strToU64( conOptList.get("epochMs", conOptList.has("api-host") ? std::to_string(DefaultApiEpochMs) : "0") );
+				if ( epochMsRec.first ) {
+					std::cout << "Invalid epochMs \n";
+					return;
+				}
+				epochMs = epochMsRec.second;
+				
+				if ( epochMs ) {
+					std::thread([memSrc, epochMs]() {
+						while( true ) {
+							std::this_thread::sleep_for( std::chrono::milliseconds(epochMs) );
+							memSrc->advanceEpoch();
+						}
+					}).detach();
+				}
+			}
+			
+			bool apiRunning = false;
+			
+			#if defined(_WIN32)
 			if ( conOptList.has("api-host") ) {
 				const auto host = conOptList.get("api-host");
 				const auto portStr = conOptList.get("api-port");
@@ -996,16 +3771,58 @@ namespace ProcessMemoryReader {
 					return;
 				}
 				
+				auto preparedExprMgr = std::make_shared< PreparedExprMgr >();
 				for(size_t i = 0; i != numWorkersU64; i++)
-					std::thread(apiWorker, tms, wrpm, baseAddress).detach();
+					std::thread(apiWorker, tms, memSrc, baseAddress, preparedExprMgr).detach();
+				
+				apiRunning = true;
+			}
+			#endif
+			
+			/// -bench:N runs every stdin line N times and prints the throughput instead of the value
+			uint64_t benchCount = 0;
+			if ( conOptList.has("bench") ) {
+				const auto rec = Builder::strToU64( conOptList.get("bench") );
+				if ( rec.first || !rec.second ) {
+					std::cout << "Invalid bench \n";
+					return;
+				}
+				
+				benchCount = rec.second;
 			}
 
 			while( true ) {
 				std::string line;
-				std::getline( std::cin, line );
+				if ( !std::getline( std::cin, line ) ) {
+					/// stdin closed (e.g. piped bench input), the api workers keep running
+					while( apiRunning )
+						std::this_thread::sleep_for( std::chrono::seconds(1) );
+					
+					return;
+				}
+				
+				if ( !epochMs )
+					memSrc->advanceEpoch();
 						
 				std::string out = "";
-				const auto error = processStruct(out, line, wrpm, baseAddress, dumpJson);
+				if ( benchCount ) {
+					uint64_t outSize = 0;
+					std::string error;
+					const auto timeStart = std::chrono::steady_clock::now();
+					for(uint64_t i = 0; ( i != benchCount ) && !error.length(); i++) {
+						error = processStruct(out, line, memSrc, baseAddress, dumpJson, false, limits);
+						outSize += out.length();
+					}
+					const double sec = std::chrono::duration< double >( std::chrono::steady_clock::now() - timeStart ).count();
+					
+					if ( error.length() )
+						std::cout << "#" << error << "\n";
+					else
+						std::cout << ATF::Reflect::stringFormat(benchCount, " requests, ", sec * 1000.0, " ms, ", benchCount / sec, " req/s, ", outSize / sec / 1e6, " MB/s out") << "\n";
+					continue;
+				}
+				
+				const auto error = processStruct(out, line, memSrc, baseAddress, dumpJson, false, limits);
 				if ( error.length() )
 					std::cout << "#" << error << "\n";
 				else
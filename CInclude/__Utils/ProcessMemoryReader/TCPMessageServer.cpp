@@ -535,6 +535,8 @@ namespace ProcessMemoryReader {
 		using MessageData = __Local__::MessageData;
 		using SP_MessageData = __Local__::SP_MessageData;
 
+		using TClientRecord = __Local__::TClientRecord;
+
 		using SP_TCPMessageServer = __Local__::SP_TCPMessageServer;
 		auto CreateTCPMessageServer(const std::string& host, const uint16_t port) {
 			auto sv = std::make_shared< __Local__::TCPMessageServer >();
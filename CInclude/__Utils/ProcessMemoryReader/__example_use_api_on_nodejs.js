@@ -77,6 +77,68 @@ function MessageBuffer(onMessage) {
 		) ;
 	}
 }
+/// MessagePack subset written by StructDumper (dumpMsgPack)
+/// uint64/int64/pointers -> BigInt, map keys -> nameID (see getNameTable)
+function MsgPackDecode(buf) {
+	let offset = 0
+	const u8 = () => buf[offset++]
+	const read = (size, fun) => {
+		const value = fun(offset)
+		offset += size
+		return value
+	}
+	const str = size => read(size, o => buf.toString('utf-8', o, o + size))
+	const array = size => Array(size).fill(0).map(() => value())
+	const map = size => {
+		const obj = new Map()
+		for(let i = 0; i < size; i++) {
+			const key = value()
+			obj.set(key, value())
+		}
+		return obj
+	}
+	const value = () => {
+		const tag = u8()
+		if ( tag <= 0x7F ) return tag
+		if ( tag <= 0x8F ) return map(tag & 0x0F)
+		if ( tag <= 0x9F ) return array(tag & 0x0F)
+		if ( tag <= 0xBF ) return str(tag & 0x1F)
+		if ( tag >= 0xE0 ) return tag - 0x100
+
+		switch( tag ) {
+			case 0xC0: return null
+			case 0xC2: return false
+			case 0xC3: return true
+			case 0xCA: return read(4, o => buf.readFloatBE(o))
+			case 0xCB: return read(8, o => buf.readDoubleBE(o))
+			case 0xCC: return read(1, o => buf.readUInt8(o))
+			case 0xCD: return read(2, o => buf.readUInt16BE(o))
+			case 0xCE: return read(4, o => buf.readUInt32BE(o))
+			case 0xCF: return read(8, o => buf.readBigUInt64BE(o))
+			case 0xD0: return read(1, o => buf.readInt8(o))
+			case 0xD1: return read(2, o => buf.readInt16BE(o))
+			case 0xD2: return read(4, o => buf.readInt32BE(o))
+			case 0xD3: return read(8, o => buf.readBigInt64BE(o))
+			case 0xD9: return str( read(1, o => buf.readUInt8(o)) )
+			case 0xDA: return str( read(2, o => buf.readUInt16BE(o)) )
+			case 0xDB: return str( read(4, o => buf.readUInt32BE(o)) )
+			case 0xDC: return array( read(2, o => buf.readUInt16BE(o)) )
+			case 0xDD: return array( read(4, o => buf.readUInt32BE(o)) )
+			case 0xDE: return map( read(2, o => buf.readUInt16BE(o)) )
+			case 0xDF: return map( read(4, o => buf.readUInt32BE(o)) )
+		}
+		throw new Error(`MsgPackDecode: unsupported tag 0x${ tag.toString(16) }`)
+	}
+	return value()
+}
+const msgPackResolveNames = (value, nameTable) => {
+	if ( value instanceof Map )
+		return Object.fromEntries( [...value].map(([k, v]) => [nameTable[k] ?? k, msgPackResolveNames(v, nameTable)]) )
+	if ( Array.isArray(value) )
+		return value.map(v => msgPackResolveNames(v, nameTable))
+	return value
+}
+
 async function createReadMemoryAPI(port = 10200, host = '127.0.0.1') {
 	let nextRpcID = 1
 	const rpcMap = Object.create(null)
@@ -84,7 +146,81 @@ async function createReadMemoryAPI(port = 10200, host = '127.0.0.1') {
 		if ( 8 <= msgData.length ) {
 			const cmdID = msgData.readInt32LE(0)
 			const rpcID = msgData.readInt32LE(4)
-			if ( cmdID === 2 ) {
+			if ( cmdID === 4 || cmdID === 6 ) {
+				const promise = rpcMap[rpcID]
+				if ( promise ) {
+					delete rpcMap[rpcID]
+					
+					try {
+						if ( cmdID === 6 )
+							promise.resolve( MsgPackDecode(msgData.slice(8)) )
+						else if ( msgData[8] !== 1 )
+							promise.resolve( {error: '#' + msgData.slice(9).toString('utf-8')} )
+						else
+							promise.resolve( MsgPackDecode(msgData.slice(9)) )
+					} catch(e) {
+						promise.resolve( {error: e.message} )
+					}
+				}
+			}
+			if ( cmdID === 16 ) {
+				const promise = rpcMap[rpcID]
+				if ( promise ) {
+					delete rpcMap[rpcID]
+					
+					try {
+						const count = msgData.readUInt32LE(8)
+						const resultList = []
+						for(let i = 0, offset = 12; i < count; i++) {
+							const ok = msgData[offset] === 1
+							const size = msgData.readUInt32LE(offset + 1)
+							const data = msgData.slice(offset + 5, offset + 5 + size)
+							offset += 5 + size
+							
+							if ( !ok )
+								resultList.push( {error: '#' + data.toString('utf-8')} )
+							else if ( promise.msgPack )
+								resultList.push( MsgPackDecode(data) )
+							else
+								resultList.push( JSON.parse(data.toString('utf-8')) )
+						}
+						promise.resolve( resultList )
+					} catch(e) {
+						promise.resolve( {error: e.message} )
+					}
+				}
+			}
+			if ( cmdID === 10 || cmdID === 12 || cmdID === 14 ) {
+				const promise = rpcMap[rpcID]
+				if ( promise ) {
+					delete rpcMap[rpcID]
+					
+					const ok = msgData[8] === 1
+					const data = msgData.slice(9)
+					try {
+						if ( cmdID === 14 )
+							promise.resolve( ok )
+						else if ( !ok )
+							promise.resolve( {error: '#' + data.toString('utf-8')} )
+						else if ( cmdID === 10 )
+							promise.resolve( data.readUInt32LE(0) )
+						else if ( promise.msgPack )
+							promise.resolve( MsgPackDecode(data) )
+						else
+							promise.resolve( JSON.parse(data.toString('utf-8')) )
+					} catch(e) {
+						promise.resolve( {error: e.message} )
+					}
+				}
+			}
+			if ( cmdID === 18 ) {
+				const promise = rpcMap[rpcID]
+				if ( promise ) {
+					delete rpcMap[rpcID]
+					promise.resolve( Number( msgData.readBigUInt64LE(8) ) )
+				}
+			}
+			if ( cmdID === 2 || cmdID === 8 ) {
 				const promise = rpcMap[rpcID]
 				if ( promise ) {
 					delete rpcMap[rpcID]
@@ -106,33 +242,135 @@ async function createReadMemoryAPI(port = 10200, host = '127.0.0.1') {
 			}
 		}
 	})
-	const getReqReadMemBuf = (code, rpcID) => {
-		const buf = Buffer.allocUnsafe(4+4+4+ code.length + 1)
+	/// limits: { maxDepth, maxArray, fields: 'm_Pos.*,m_dwHP', ptrDepth }, sent after the code as "key=value;...".
+	/// ptrDepth > 0 returns the object graph { '0x<address>': object, ... }
+	const getReqReadMemBuf = (code, rpcID, cmdID = 1, limits = {}) => {
+		const limitsText = Object.entries(limits)
+			.filter(([k, v]) => v !== undefined && v !== null)
+			.map(([k, v]) => `${k}=${v};`)
+			.join('')
+		
+		const payload = Buffer.from( limitsText.length ? code + '\0' + limitsText + '\0' : code + '\0' )
+		const buf = Buffer.allocUnsafe(4+4+4+ payload.length)
 		buf.writeInt32LE(buf.length, 0)
-		buf.writeInt32LE(1, 4)
+		buf.writeInt32LE(cmdID, 4)
 		buf.writeInt32LE(rpcID, 8)
-		Buffer.from(code).copy( buf.slice(12) )
-		buf[buf.length-1] = 0
+		payload.copy( buf, 12 )
 		return buf
 	}
 
+	const getReqHandleBuf = (handle, rpcID, cmdID, format) => {
+		const buf = Buffer.alloc(4+4+4+4 + ( format === undefined ? 0 : 1 ))
+		buf.writeInt32LE(buf.length, 0)
+		buf.writeInt32LE(cmdID, 4)
+		buf.writeInt32LE(rpcID, 8)
+		buf.writeUInt32LE(handle, 12)
+		if ( format !== undefined )
+			buf[16] = format
+		return buf
+	}
+
+	/// itemList: [ 'code' | { code, limits } | { handle } ]
+	const getReqBatchBuf = (itemList, rpcID, format) => {
+		const partList = itemList.map(item => {
+			if ( item.handle !== undefined ) {
+				const buf = Buffer.alloc(1 + 4)
+				buf[0] = 1
+				buf.writeUInt32LE(item.handle, 1)
+				return buf
+			}
+			
+			const code = ( typeof item === 'string' ) ? item : item.code
+			const limitsText = Object.entries(item.limits ?? {})
+				.filter(([k, v]) => v !== undefined && v !== null)
+				.map(([k, v]) => `${k}=${v};`)
+				.join('')
+			return Buffer.concat([ Buffer.from([0]), Buffer.from(code + '\0' + limitsText + '\0') ])
+		})
+		
+		const head = Buffer.alloc(4+4+4 + 1 + 4)
+		const body = Buffer.concat(partList)
+		head.writeInt32LE(head.length + body.length, 0)
+		head.writeInt32LE(15, 4)
+		head.writeInt32LE(rpcID, 8)
+		head[12] = format
+		head.writeUInt32LE(itemList.length, 13)
+		return Buffer.concat([ head, body ])
+	}
+
 	return new Promise((res, rej) => {
 		try {
 
 			const socket = net.createConnection(port, host, () => {
 
-				const dumpMemory = async (code) => {
+				const request = (code, cmdID, limits) => {
 					const rpcID = (nextRpcID++)|0
 					const promise = PromiseEx()
 
 					rpcMap[ rpcID ] = promise
-					socket.write( getReqReadMemBuf(code, rpcID) )
+					socket.write( getReqReadMemBuf(code, rpcID, cmdID, limits) )
 					//console.log('write!')
 					return promise
 				}
+				const requestHandle = (handle, cmdID, format) => {
+					const rpcID = (nextRpcID++)|0
+					const promise = PromiseEx()
+					promise.msgPack = format === 1
+
+					rpcMap[ rpcID ] = promise
+					socket.write( getReqHandleBuf(handle, rpcID, cmdID, format) )
+					return promise
+				}
+				
+				const dumpMemory = async (code, limits) => request(code, 1, limits)
+				
+				/// Handles live until release or until the connection closes
+				const prepare = async (code, limits) => request(code, 9, limits)
+				const execute = async (handle) => requestHandle(handle, 11, 0)
+				const executeMsgPack = async (handle) => {
+					const [nameTable, value] = await Promise.all([ getNameTable(), requestHandle(handle, 11, 1) ])
+					if ( value?.error )
+						return value
+					
+					return msgPackResolveNames(value, nameTable)
+				}
+				const release = async (handle) => requestHandle(handle, 13)
+				
+				/// One request and one response for all items, results are in item order
+				const dumpMemoryBatch = async (itemList) => {
+					const rpcID = (nextRpcID++)|0
+					const promise = PromiseEx()
+
+					rpcMap[ rpcID ] = promise
+					socket.write( getReqBatchBuf(itemList, rpcID, 0) )
+					return promise
+				}
+				const getStats = async () => request('', 7)
+				
+				/// Page cache (-pageCache): reads after this see a new snapshot of the target memory (the server also advances every -epochMs, 100 ms by default)
+				const advanceEpoch = async () => request('', 17)
+				
+				let nameTablePromise = null
+				const getNameTable = () => nameTablePromise ??= request('', 5)
+				const dumpMemoryMsgPack = async (code, limits) => {
+					const [nameTable, value] = await Promise.all([ getNameTable(), request(code, 3, limits) ])
+					if ( value?.error )
+						return value
+					
+					return msgPackResolveNames(value, nameTable)
+				}
 				
 				res({ 
 					dumpMemory, 
+					dumpMemoryMsgPack, 
+					getNameTable, 
+					getStats, 
+					prepare, 
+					execute, 
+					executeMsgPack, 
+					release, 
+					dumpMemoryBatch, 
+					advanceEpoch, 
 					getSocket: () => socket,
 				})
 			})
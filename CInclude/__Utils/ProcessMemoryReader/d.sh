@@ -0,0 +1,8 @@
+#!/bin/sh
+# Linux build (g++ >= 7 or clang), same generated ATF headers as d.cmd. The api server (-api-host) is Windows only
+
+rm -f main
+g++ -std=c++17 -O2 -Wall -o main main.cpp -lpthread || exit 1
+
+
+./main -target:"ZoneServerUD_x64.exe" -baseAddress:0x140000000 -dumpJson
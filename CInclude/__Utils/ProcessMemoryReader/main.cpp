@@ -5,17 +5,37 @@
 #include <mutex>
 #include <vector>
 #include <array>
+#include <list>
+#include <thread>
+#include <chrono>
+#include <functional>
 
 #include <map>
 #include <unordered_map>
 #include <string>
 #include <sstream>
+#include <fstream>
 
-#include <windows.h>
-#include <tlhelp32.h>
+#if defined(_WIN32)
+	#include <windows.h>
+	#include <tlhelp32.h>
+#elif defined(__linux__)
+	#include <cerrno>
+	#include <cstring>
+	#include <dirent.h>
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
 
 #define ATF_COMPILE_WITH_CHECK_ALL
 #define ATF_COMPILE_WITH_REFLECT_STRUCT_INFO
+#if !defined(_WIN32) && !defined(ATF_COMPILE_WITHOUT_HOOK)
+	#define ATF_COMPILE_WITHOUT_HOOK		/// Hooks live inside the Windows target, the Linux reader only reads memory
+#endif
 #include "../../Include.hpp"
 
 #include "ProcessMemoryReader_1_0_0.cpp"
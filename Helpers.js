@@ -540,6 +540,75 @@ export const binaryWriter = () => {
 	return this_
 }
 
+/// Must match ATF::__Local__::nameHash (CInclude/Reflect/NameHash.cpp)
+export const nameHashBytes = (bytes, seed, salt = 0) => {
+	let h = (2166136261 ^ seed) >>> 0
+
+	for(let i = 0; i < 4; i++)
+		h = Math.imul( h ^ ( ( salt >>> (i * 8) ) & 0xFF ), 16777619 ) >>> 0
+
+	for(const b of bytes)
+		h = Math.imul( h ^ b, 16777619 ) >>> 0
+
+	h = Math.imul( h ^ (h >>> 16), 0x85EBCA6B ) >>> 0
+	h = Math.imul( h ^ (h >>> 13), 0xC2B2AE35 ) >>> 0
+	return ( h ^ (h >>> 16) ) >>> 0
+}
+export const nameHash = (name, seed, salt = 0) => nameHashBytes(Buffer.from(name, 'utf-8'), seed, salt)
+
+/// Minimal perfect hash (hash & displace): slot = nameHash(key, seedList[ nameHash(key, 0) % seedCount ]) % slotCount
+/// keyList: [{ name, salt, value }]
+export const buildPerfectHash = (keyList, keysPerSeed = 4) => {
+	assert( aIsUnq( keyList.map(k => `${ k.salt ?? 0 }:${ k.name }`) ) )
+
+	const slotCount = keyList.length
+	const seedCount = Math.max( 1, Math.ceil( slotCount / keysPerSeed ) )
+
+	const buckets = Array(seedCount).fill(0).map(() => [])
+	keyList
+		.map(k => ({ ...k, salt: k.salt ?? 0, bytes: Buffer.from(k.name, 'utf-8') }))
+		.map(k => buckets[ nameHashBytes(k.bytes, 0, k.salt) % seedCount ].push(k))
+
+	const seedList = Array(seedCount).fill(0)
+	const slotList = Array(slotCount).fill(null)
+	const slotUsed = new Uint8Array(slotCount)
+
+	buckets
+		.map((keys, i) => ({ keys, i }))
+		.filter(b => b.keys.length)
+		.sort((l, r) => r.keys.length - l.keys.length)
+		.map(b => {
+			for(let seed = 1; ; seed++) {
+				assert( seed < 0x7FFFFFFF )
+
+				const slots = b.keys.map(k => nameHashBytes(k.bytes, seed, k.salt) % slotCount)
+				if ( slots.some(s => slotUsed[s]) || new Set(slots).size !== slots.length )
+					continue
+
+				slots.map((s, j) => ( slotUsed[s] = 1, slotList[s] = b.keys[j].value ))
+				seedList[ b.i ] = seed
+				return
+			}
+		})
+
+	return { seedList, slotList, seedCount, slotCount, }
+}
+
+/// Sorted list -> Eytzinger (BFS) order, 1-based: out[0] = null, children of k are 2k and 2k+1
+export const eytzingerLayout = sortedList => {
+	const out = Array(sortedList.length + 1).fill(null)
+	let i = 0
+	const build = k => {
+		if ( k > sortedList.length )
+			return
+		build(2 * k)
+		out[ k ] = sortedList[ i++ ]
+		build(2 * k + 1)
+	}
+	build(1)
+	return out
+}
+
 export const codeFrame = (parent) => {
 		const lines = []
 		
@@ -0,0 +1,253 @@
+import fs from 'fs'
+import path from 'path'
+import url from 'url'
+
+import { assert, mObj, buildLines, fTextPadStart, codeFrame, GAP, } from '../Helpers.js'
+import { CTypeMap } from '../CTypes.js'
+import { codeReflectModule, codeReflectStructInfo, codeReflectFuncList, } from '../Builder/Builder.js'
+
+/// Small known type/func set emitted through the Builder table code, the pdb pipeline (cvdump/undname) is Windows only.
+/// node Tests/Fixture.js <outDir> writes AG_Header.hpp, AG_CheckAll.cpp and Reflect/AG_*.cpp, build with -I <outDir>
+
+const BaseAddressX64 = 0x140000000n
+
+/// Field: [ name, offset, type ] or [ name, offset, type, startingPosition, bits ] for bitfields.
+/// Type: scalar or struct name, 'T*' pointer, [ type, count ] array
+export const FixtureStructList = [
+	{ name: 'CPos', type: 'TypeStruct', size: 0x0C, fields: [
+		[ 'x', 0x00, 'float32_t' ],
+		[ 'y', 0x04, 'float32_t' ],
+		[ 'z', 0x08, 'float32_t' ],
+	] },
+	{ name: 'UValue', type: 'TypeUnion', size: 0x08, fields: [
+		[ 'm_nValue' , 0x00, 'int64_t'          ],
+		[ 'm_fValue' , 0x00, 'float64_t'        ],
+		[ 'm_byValue', 0x00, [ 'uint8_t', 8 ]   ],
+	] },
+	{ name: 'CPlayer', type: 'TypeStruct', size: 0x70, fields: [
+		[ 'm_dwObjSerial', 0x00, 'uint32_t'          ],
+		[ 'm_Pos'        , 0x04, 'CPos'              ],
+		[ 'm_szName'     , 0x10, [ 'char', 16 ]      ],
+		[ 'm_nHP'        , 0x20, 'int32_t'           ],
+		[ 'm_bLive'      , 0x24, 'bool'              ],
+		[ 'm_pNext'      , 0x28, 'CPlayer*'          ],
+		[ 'm_nLevel'     , 0x30, 'uint32_t', 3, 5    ],
+		[ 'm_wArr'       , 0x34, [ 'uint16_t', 4 ]   ],
+		[ 'm_PosArr'     , 0x3C, [ 'CPos', 2 ]       ],
+		[ 'm_f64'        , 0x58, 'float64_t'         ],
+		[ 'm_nGold'      , 0x60, 'int64_t'           ],
+		[ 'm_Value'      , 0x68, 'UValue'            ],
+	] },
+	/// More pointers than one process_vm_readv takes (MaxIovCount), for ptrDepth dumps in Tests/ProcessMemoryReader
+	{ name: 'CParty', type: 'TypeStruct', size: 0x3008, fields: [
+		[ 'm_nCount'     , 0x00, 'uint32_t'             ],
+		[ 'm_pMember'    , 0x08, [ 'CPlayer*', 0x600 ]  ],
+	] },
+]
+
+export const FixtureVarList = [
+	{ name: 'g_Player'         , type: 'CPlayer', address: 0x140020000n, },
+	{ name: 'CPlayer::s_nCount', type: 'int32_t', address: 0x140020100n, isStaticDataMember: true, },
+]
+
+/// Address order differs from internalID order, main has no procedure record (size 0),
+/// CPlayer::AttackResume is a size 0 symbol inside the second CPlayer::Attack
+export const FixtureFuncList = [
+	{ name: 'CPlayer::Attack'      , address: 0x140010000n, size: 0x40, isStatic: false, isMethod: true , },
+	{ name: 'CPlayer::AttackEx'    , address: 0x140010040n, size: 0x20, isStatic: false, isMethod: true , },
+	{ name: 'CPos::Len'            , address: 0x140010100n, size: 0x10, isStatic: false, isMethod: true , },
+	{ name: 'CPlayer::GetCount'    , address: 0x140010080n, size: 0x08, isStatic: true , isMethod: true , },
+	{ name: 'CPlayer::Attack'      , address: 0x140010200n, size: 0x30, isStatic: false, isMethod: true , },
+	{ name: 'main'                 , address: 0x140011000n, size: 0x00, isStatic: true , isMethod: false, },
+	{ name: 'CPlayer::AttackResume', address: 0x140010210n, size: 0x00, isStatic: false, isMethod: true , },
+]
+
+const parseType = t => {
+	if ( Array.isArray(t) )
+		return { kind: 'array', elementType: parseType(t[0]), count: t[1] }
+
+	if ( t.endsWith('*') )
+		return { kind: 'pointer', elementType: parseType(t.slice(0, -1)) }
+
+	return { kind: CTypeMap[ t ] ? 'scalar' : 'struct', name: t }
+}
+
+const structMap = mObj( Object.fromEntries(FixtureStructList.map(s => [s.name, s])) )
+
+const typeSize = t => {
+	switch( t.kind ) {
+		case 'scalar' : return assert( CTypeMap[ t.name ] ).size
+		case 'struct' : return assert( structMap[ t.name ] ).size
+		case 'pointer': return 8
+		case 'array'  : return typeSize(t.elementType) * t.count
+	}
+	assert( false )
+}
+
+/// Same records and id order as all_DumpCodeReflectStruct: structs, then the fields of each struct in one run, then vars
+export const buildFixtureTypeList = () => {
+	const typeNameMap = mObj({})
+	const typeList = [null]
+	const typeCache = (name, type, size = 0, elementTypeID = 0, offset = 0, options = {}) => {
+		if ( name && typeNameMap[ name ] )
+			return typeNameMap[ name ].id
+
+		const newType = { id: typeList.length, name, type, size, elementTypeID, offset, ...options, }
+		typeList.push( newType )
+		if ( name )
+			typeNameMap[ name ] = newType
+		return newType.id
+	}
+	const typeProcess = t => {
+		switch( t.kind ) {
+			case 'scalar' : return typeCache( t.name, 'TypeScalar', typeSize(t) )
+			case 'struct' : return assert( typeNameMap[ t.name ] ).id
+			case 'pointer': return typeCache( null, 'TypePointer', 8, typeProcess(t.elementType) )
+			case 'array'  : return typeCache( null, 'TypeArray', typeSize(t), typeProcess(t.elementType) )
+		}
+		assert( false )
+	}
+
+	FixtureStructList
+		.map(s => typeCache(s.name, s.type, s.size) )
+
+	FixtureStructList
+		.map(s => {
+			typeNameMap[ s.name ].fieldIdRng = s
+				.fields
+				.map(([name, offset, type, startingPosition, bits]) => [name, offset, type, bits ?
+					typeCache( null, 'TypeBitfield', typeSize(parseType(type)), typeProcess(parseType(type)), 0, { startingPosition, bits, } ) :
+					typeProcess(parseType(type)) ])
+				.map(([name, offset, type, resType]) => typeCache(null, 'TypeDataMemberField', typeSize(parseType(type)), resType, offset) )
+				.map((id, i) => ( typeList[id].name = s.fields[i][0], id ) )
+				.$next(a => [a.at(0), a.length])
+		})
+
+	FixtureVarList
+		.map(v => typeCache(v.name, v.isStaticDataMember ? 'TypeStaticDataMemberField' : 'TypeVar', typeSize(parseType(v.type)), typeProcess(parseType(v.type)), 0, { address: v.address, }) )
+
+	return typeList
+}
+
+export const buildFixtureFuncList = () => FixtureFuncList
+	.map((f, internalID) => ({
+		internalID,
+		nameParts: f.name.split('::'),
+		address  : { absAddress: f.address, absAddressCode: `0x${ f.address.toString(16).toUpperCase() }`, },
+		size     : f.size,
+		isStatic : f.isStatic,
+		isMethod : f.isMethod,
+	}))
+
+const codeCppType = (t, name) => {
+	switch( t.kind ) {
+		case 'scalar' :
+		case 'struct' : return `${ t.name } ${ name }`
+		case 'pointer': return codeCppType(t.elementType, `*${ name }`)
+		case 'array'  : return codeCppType(t.elementType, `${ name }[${ t.count }]`)
+	}
+	assert( false )
+}
+
+/// Packed structs with explicit padding, bitfields fill their whole storage unit so the layout is the same for MSVC and g++
+const codeHeader = () => {
+	const acHeader = codeFrame()
+		.createFileFrame()
+
+	FixtureStructList
+		.map(s => `${ s.type === 'TypeUnion' ? 'union' : 'struct' } ${ s.name };`)
+		.map(acHeader)
+
+	const acPacked = acHeader.createPackedFrame()
+	FixtureStructList
+		.map(s => {
+			let offset = 0
+			const lines = []
+			s.fields.map(([name, fieldOffset, type, startingPosition, bits]) => {
+				if ( s.type !== 'TypeUnion' ) {
+					if ( fieldOffset > offset )
+						lines.push(`uint8_t _pad_${ offset.toString(16) }[${ fieldOffset - offset }];`)
+					assert( fieldOffset >= offset )
+				}
+
+				const size = typeSize(parseType(type))
+				if ( bits ) {
+					lines.push(
+						startingPosition && `${ type } : ${ startingPosition };`,
+						`${ type } ${ name } : ${ bits };`,
+						( startingPosition + bits < size * 8 ) && `${ type } : ${ size * 8 - startingPosition - bits };`,
+					)
+				} else {
+					lines.push(`${ codeCppType(parseType(type), name) };`)
+				}
+				offset = fieldOffset + size
+			})
+			if ( ( s.type !== 'TypeUnion' ) && ( s.size > offset ) )
+				lines.push(`uint8_t _pad_${ offset.toString(16) }[${ s.size - offset }];`)
+
+			return buildLines(
+				`${ s.type === 'TypeUnion' ? 'union' : 'struct' } ${ s.name } {`,
+				buildLines(...lines.filter(Boolean)).$next(fTextPadStart(GAP)),
+				`};`,
+			)
+		})
+		.map(acPacked)
+
+	return acHeader.buildRoot()
+}
+
+const codeCheckAll = () => {
+	const acCheckCode = codeFrame()
+		.createFileFrame()
+		.createNamespaceFrame('CheckAll')
+
+	acCheckCode(`void checkAll() {`)
+	const rc = name => `reinterpret_cast< ${ name }* >( 0xFFFFFF )`
+	FixtureStructList
+		.map(s => buildLines(
+			`assert( sizeof(${ s.name }) == ${ s.size } );`,
+			...s.fields
+				.filter(f => !f[4])
+				.map(([name, offset]) => `assert( (size_t)( &${ rc(s.name) }->${ name } ) == ( 0xFFFFFF + ${ offset } ) );`),
+		))
+		.map(fTextPadStart(GAP))
+		.map(acCheckCode)
+	acCheckCode(`}`)
+
+	return acCheckCode.buildRoot()
+}
+
+const codeEmpty = () => codeFrame()
+	.createFileFrame()
+	.buildRoot()
+
+export const buildFixtureFiles = () => {
+	const codeStructInfo = codeReflectStructInfo( buildFixtureTypeList() )
+	const codeFuncList   = codeReflectFuncList( buildFixtureFuncList() )
+
+	return {
+		'AG_Header.hpp'               : codeHeader(),
+		'AG_CheckAll.cpp'             : codeCheckAll(),
+		'AG_Source.cpp'               : codeEmpty(),
+		'AG_Vars.cpp'                 : codeEmpty(),
+		'Hook/AG_Hook.hpp'            : codeEmpty(),
+		'Hook/AG_Hook.cpp'            : codeEmpty(),
+		'Reflect/AG_Module.hpp'       : codeReflectModule([null], BaseAddressX64).replace(/\{ATF_SIGNATURE_U64\}/g, '0'),
+		'Reflect/AG_StructInfoList.cpp': codeStructInfo.structInfoList,
+		'Reflect/AG_StructInfo.cpp'   : codeStructInfo.structInfo,
+		'Reflect/AG_FuncNameList.cpp' : codeFuncList.funcNameList,
+		'Reflect/AG_FuncInfoList.cpp' : codeFuncList.funcInfoList,
+		'Reflect/AG_FuncInfo.cpp'     : codeEmpty(),
+	}
+}
+
+if ( process.argv[1] && ( path.resolve(process.argv[1]) === url.fileURLToPath(import.meta.url) ) ) {
+	const outDir = assert( process.argv[2] )
+	Object
+		.entries( buildFixtureFiles() )
+		.map(([file, data]) => {
+			const absFile = path.join(outDir, file)
+			fs.mkdirSync( path.dirname(absFile), { recursive: true } )
+			fs.writeFileSync(absFile, data)
+		})
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#!/bin/sh
+# Linux reader against a live target (target.cpp) with the fixture types of Tests/Fixture.js. g++ >= 7 or clang, run from this directory
+node ../Fixture.js _fixture || exit 1
+rm -f main target addr.txt
+g++ -std=c++17 -O2 -Wall -I _fixture -o target target.cpp || exit 1
+g++ -std=c++17 -O2 -Wall -I _fixture -o main ../../CInclude/__Utils/ProcessMemoryReader/main.cpp -lpthread || exit 1
+
+./target > addr.txt &
+TARGET_PID=$!
+trap 'kill $TARGET_PID 2>/dev/null' EXIT
+
+for i in $(seq 50); do
+	[ -s addr.txt ] && break
+	sleep 0.1
+done
+eval "$(tr ' ' '\n' < addr.txt)"
+[ -n "$PARTY" ] || { echo "FAIL: no addresses from target"; exit 1; }
+
+CHECK_COUNT=0
+FAIL_COUNT=0
+
+# check <expected> <query> [reader options]
+check() {
+	expected="$1"
+	query="$2"
+	shift 2
+	CHECK_COUNT=$((CHECK_COUNT + 1))
+	out=$(printf '%s\n' "$query" | ./main -pid:$TARGET_PID -dumpJson "$@")
+	[ "$out" = "$expected" ] && return
+	FAIL_COUNT=$((FAIL_COUNT + 1))
+	printf 'FAIL: %s %s\n  got:      %s\n  expected: %s\n' "$query" "$*" "$out" "$expected"
+}
+
+PLAYERS="each(reinterpret_cast<CPlayer*>($P), ->m_pNext)"
+
+check '100'                   "reinterpret_cast<CPlayer*>($P)->m_nHP"
+check '"p0"'                  "reinterpret_cast<CPlayer*>($P)->m_szName"
+check '"3"'                   "count($PLAYERS)"
+check '"9223372036854775806"' "sum($PLAYERS, m_nGold)"
+check '3.000000'              "max($PLAYERS, m_f64)"
+check '-1.000000'             "min($PLAYERS, m_f64)"
+check '[
+  "1", 
+  "7"
+]'                            "select(where($PLAYERS, m_bLive), m_nLevel)"
+check '"2"'                   "count(each(reinterpret_cast<CPlayer*>($Q), ->m_pNext))"
+
+check '[10, 20, 30]'          "select(std::vector<CPlayer>(*reinterpret_cast<CPlayer*>($VEC_PLAYER)), m_nHP)"
+check '"2"'                   "count(where(std::vector<CPlayer>(*reinterpret_cast<CPlayer*>($VEC_PLAYER)), m_bLive))"
+check '[5, 6, 7]'             "std::vector<int32_t>(*reinterpret_cast<int32_t*>($VEC_INT))"
+check '"0"'                   "count(std::vector<int32_t>(*reinterpret_cast<int32_t*>($VEC_EMPTY)))"
+check '[501, 502]'            "select(std::list<CPlayer>(*reinterpret_cast<CPlayer*>($LIST_PLAYER)), m_nHP)"
+check '"5"'                   "count(std::map<int32_t, CPlayer>(*reinterpret_cast<int32_t*>($MAP_PLAYER)))"
+check '[
+  [7, 70], 
+  [9, 90]
+]'                            "std::map<int32_t, int32_t>(*reinterpret_cast<int32_t*>($MAP_INT))"
+check '"0"'                   "count(std::map<int32_t, int32_t>(*reinterpret_cast<int32_t*>($MAP_EMPTY)))"
+
+# m_nHP of BAD ends 2 bytes into the unreadable page
+BAD_HP=$(printf '0x%x' $((BAD + 0x20)))
+check "#[$BAD_HP(4)] Not in a readable region"                          "reinterpret_cast<CPlayer*>($BAD)->m_nHP"
+check "#[$BAD_HP(4)] Only part of a process_vm_readv request was completed" "reinterpret_cast<CPlayer*>($BAD)->m_nHP" -regionCheck:0
+check '"0"'                                                             "reinterpret_cast<CPlayer*>($BAD)->m_dwObjSerial" -regionCheck:0
+
+# Members of the party are one graph level: more ranges than MaxIovCount (several process_vm_readv calls). Without the region
+# check member 1000 is a partial read inside the first call, it is retried alone, dumped as null and the members after it still read
+EXPECTED_HP=$(seq 0 1535 | grep -vx 1000 | sed 's/^/"m_nHP": /')
+for regionCheck in 1 0; do
+	CHECK_COUNT=$((CHECK_COUNT + 1))
+	out=$(printf '%s\n' "*reinterpret_cast<CParty*>($PARTY)" | ./main -pid:$TARGET_PID -dumpJson -fields:m_pMember,m_nHP -ptrDepth:1 -regionCheck:$regionCheck)
+	if [ "$(printf '%s\n' "$out" | grep -o '"m_nHP": [0-9]*')" != "$EXPECTED_HP" ] || ! printf '%s\n' "$out" | grep -qx "  \"$(printf '0x%016X' $BAD)\": null,"; then
+		FAIL_COUNT=$((FAIL_COUNT + 1))
+		echo "FAIL: CParty graph -regionCheck:$regionCheck"
+	fi
+done
+
+if [ $FAIL_COUNT -ne 0 ]; then
+	echo "$FAIL_COUNT of $CHECK_COUNT checks failed"
+	exit 1
+fi
+echo "$CHECK_COUNT/$CHECK_COUNT checks passed"
@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+/// Target process of d.sh: known objects of the Tests/Fixture.js types, the addresses are printed as NAME=0x... on one line
+#include "../../CInclude/Types.hpp"
+#include "AG_Header.hpp"
+
+using namespace ATF;
+
+/// MSVC x64 container layouts (see MsvcStdLayout of the reader), built by hand so the test does not depend on the local STL
+struct TMsvcVector {
+	void* first;
+	void* last;
+	void* end;
+};
+struct TMsvcContainer {
+	uint8_t* head;
+	uint64_t size;
+};
+
+void setPointer(uint8_t* pNode, const size_t offset, const void* value) {
+	memcpy(pNode + offset, &value, 8);
+}
+
+template< class T >
+TMsvcVector makeVector(std::vector< T >& list) {
+	return { list.data(), list.data() + list.size(), list.data() + list.size() };
+}
+
+/// Circular list around the head node: next @0, prev @8, value @16
+template< class T >
+TMsvcContainer makeList(const std::vector< T >& valueList) {
+	const size_t nodeSize = 16 + sizeof(T);
+	uint8_t* head = (uint8_t*)calloc(1, nodeSize);
+	uint8_t* prev = head;
+	for(const auto& value : valueList) {
+		uint8_t* node = (uint8_t*)calloc(1, nodeSize);
+		memcpy(node + 16, &value, sizeof(T));
+		setPointer(prev, 0, node);
+		setPointer(node, 8, prev);
+		prev = node;
+	}
+	setPointer(prev, 0, head);
+	setPointer(head, 8, prev);
+	return { head, valueList.size() };
+}
+
+/// Red-black tree node: left @0, parent @8, right @16, color @24, isnil @25, then the key/value pair (aligned).
+/// Balanced tree over the sorted nodes [first, last), nil children point to the head
+uint8_t* linkTree(std::vector< uint8_t* >& nodeList, const size_t first, const size_t last, uint8_t* parent, uint8_t* head) {
+	if ( first == last )
+		return head;
+
+	const size_t middle = ( first + last ) / 2;
+	uint8_t* node = nodeList[ middle ];
+	setPointer(node, 0 , linkTree(nodeList, first, middle, node, head));
+	setPointer(node, 8 , parent);
+	setPointer(node, 16, linkTree(nodeList, middle + 1, last, node, head));
+	return node;
+}
+template< class K, class V >
+TMsvcContainer makeMap(const std::vector< std::pair< K, V > >& pairList, const size_t pairOffset, const size_t secondOffset) {
+	const size_t nodeSize = pairOffset + secondOffset + sizeof(V);
+	uint8_t* head = (uint8_t*)calloc(1, nodeSize);
+	head[25] = 1;
+
+	std::vector< uint8_t* > nodeList;
+	for(const auto& pair : pairList) {
+		uint8_t* node = (uint8_t*)calloc(1, nodeSize);
+		memcpy(node + pairOffset, &pair.first, sizeof(K));
+		memcpy(node + pairOffset + secondOffset, &pair.second, sizeof(V));
+		nodeList.push_back(node);
+	}
+
+	const auto root = linkTree(nodeList, 0, nodeList.size(), head, head);
+	setPointer(head, 0 , nodeList.size() ? nodeList.front() : head);
+	setPointer(head, 8 , root);
+	setPointer(head, 16, nodeList.size() ? nodeList.back() : head);
+	return { head, pairList.size() };
+}
+
+CPlayer makePlayer(const int32_t hp) {
+	CPlayer player = {};
+	player.m_nHP = hp;
+	return player;
+}
+
+int main() {
+	/// Readers that are not the parent (d.sh starts both) need this under Yama ptrace_scope 1
+	prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+
+	/// p[0] -> p[1] -> p[2]: sum of m_nGold wraps, m_f64 starts with a NaN
+	static CPlayer p[3] = {};
+	const int64_t goldList[3] = { INT64_MAX, 1, -2 };
+	const double  f64List [3] = { NAN, 3.0, -1.0 };
+	for(int32_t i = 0; i < 3; i++) {
+		p[i].m_dwObjSerial = 0x10 + i;
+		snprintf(p[i].m_szName, sizeof(p[i].m_szName), "p%d", i);
+		p[i].m_nHP     = 100 + i;
+		p[i].m_bLive   = i != 1;
+		p[i].m_nLevel  = 3 * i + 1;
+		p[i].m_f64     = f64List[i];
+		p[i].m_nGold   = goldList[i];
+		p[i].m_pNext   = ( i != 2 ) ? &p[i + 1] : nullptr;
+	}
+
+	/// q[0] <-> q[1]
+	static CPlayer q[2] = { makePlayer(1), makePlayer(2) };
+	q[0].m_pNext = &q[1];
+	q[1].m_pNext = &q[0];
+
+	static std::vector< CPlayer > vecPlayerData = { makePlayer(10), makePlayer(20), makePlayer(30) };
+	vecPlayerData[1].m_bLive = true;
+	vecPlayerData[2].m_bLive = true;
+	static std::vector< int32_t > vecIntData = { 5, 6, 7 };
+	static std::vector< int32_t > vecEmptyData;
+	static TMsvcVector vecPlayer = makeVector(vecPlayerData);
+	static TMsvcVector vecInt    = makeVector(vecIntData);
+	static TMsvcVector vecEmpty  = makeVector(vecEmptyData);
+
+	static TMsvcContainer listPlayer = makeList< CPlayer >({ makePlayer(501), makePlayer(502) });
+
+	/// std::map< int32_t, CPlayer >: pair @32 (CPlayer has 8 byte fields), CPlayer @+8. std::map< int32_t, int32_t >: pair @28, value @+4
+	std::vector< std::pair< int32_t, CPlayer > > playerPairList;
+	for(int32_t key = 1; key <= 5; key++)
+		playerPairList.push_back({ key, makePlayer(key * 1000) });
+	static TMsvcContainer mapPlayer = makeMap(playerPairList, 32, 8);
+	static TMsvcContainer mapInt    = makeMap< int32_t, int32_t >({ { 7, 70 }, { 9, 90 } }, 28, 4);
+	static TMsvcContainer mapEmpty  = makeMap< int32_t, int32_t >({}, 28, 4);
+
+	/// CParty: more members than one process_vm_readv takes, member BadMember has m_nHP across the end of the readable page
+	/// (a partial read of its range inside a batch). Members are separate allocations, m_nHP is the index
+	const size_t BadMember = 1000;
+	const size_t pageSize  = (size_t)sysconf(_SC_PAGESIZE);
+	uint8_t* pPages = (uint8_t*)mmap(nullptr, pageSize * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if ( pPages == MAP_FAILED ) {
+		printf("mmap failed\n");
+		return 1;
+	}
+	CPlayer* pBad = reinterpret_cast< CPlayer* >( pPages + pageSize - offsetof(CPlayer, m_nHP) - 2 );
+	mprotect(pPages + pageSize, pageSize, PROT_NONE);
+
+	static CParty party = {};
+	party.m_nCount = sizeof(party.m_pMember) / sizeof(party.m_pMember[0]);
+	for(uint32_t i = 0; i != party.m_nCount; i++)
+		party.m_pMember[i] = ( i == BadMember ) ? pBad : new CPlayer( makePlayer((int32_t)i) );
+
+	printf("P=%p Q=%p VEC_PLAYER=%p VEC_INT=%p VEC_EMPTY=%p LIST_PLAYER=%p MAP_PLAYER=%p MAP_INT=%p MAP_EMPTY=%p PARTY=%p BAD=%p\n",
+		(void*)p, (void*)q, (void*)&vecPlayer, (void*)&vecInt, (void*)&vecEmpty, (void*)&listPlayer, (void*)&mapPlayer, (void*)&mapInt, (void*)&mapEmpty, (void*)&party, (void*)pBad);
+	fflush(stdout);
+
+	while( true )
+		pause();
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+If not defined AlrInitEvrMsvc (
+	@set AlrInitEvrMsvc=1
+	"c:\Program Files (x86)\Microsoft Visual Studio\2017\BuildTools\VC\Auxiliary\Build\vcvars64.bat"
+)
+
+node ..\Fixture.js _fixture || exit /b 1
+
+del main.exe
+cls
+
+cl.exe /Od /EHc /EHs /I _fixture main.cpp
+
+main
\ No newline at end of file
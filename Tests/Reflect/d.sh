@@ -0,0 +1,9 @@
+#!/bin/sh
+# Fixture headers (Tests/Fixture.js), then the checks. g++ >= 10 or clang, run from this directory
+node ../Fixture.js _fixture || exit 1
+rm -f main main20
+g++ -std=c++17 -O2 -Wall -I _fixture -o main main.cpp -lpthread || exit 1
+# static_asserts: offsetOf("S", "f") as C++14 constexpr, the template forms offsetOf<"S", "f">()/fieldType<> need C++20
+g++ -std=c++14 -fsyntax-only -I _fixture main.cpp || exit 1
+g++ -std=c++20 -O2 -Wall -I _fixture -o main20 main.cpp -lpthread || exit 1
+./main && ./main20
@@ -0,0 +1,325 @@
+#include <iostream>
+#include <cassert>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <array>
+#include <list>
+#include <thread>
+#include <chrono>
+#include <functional>
+
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <sstream>
+#include <fstream>
+
+#if defined(_WIN32)
+	#include <windows.h>
+	#include <tlhelp32.h>
+#elif defined(__linux__)
+	#include <cerrno>
+	#include <cstring>
+	#include <dirent.h>
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif
+
+/// Checks of the Reflect tables and the reader against the fixture of Tests/Fixture.js (generated headers come from -I <fixture dir>)
+#define ATF_COMPILE_WITH_CHECK_ALL
+#define ATF_COMPILE_WITH_REFLECT_STRUCT_INFO
+#define ATF_COMPILE_WITHOUT_HOOK
+#include "../../CInclude/Include.hpp"
+
+#include "../../CInclude/__Utils/ProcessMemoryReader/ProcessMemoryReader_1_0_0.cpp"
+
+namespace Tests {
+	int32_t g_CheckCount = 0;
+	int32_t g_FailCount  = 0;
+
+	template< class... TArgs >
+	void check(const bool ok, const TArgs&... args) {
+		g_CheckCount++;
+		if ( ok )
+			return;
+
+		g_FailCount++;
+		std::cout << "FAIL: " << ATF::Reflect::stringFormat(args...) << "\n";
+	}
+
+	std::string toHex(const std::string& bytes) {
+		static const char* HexDigits = "0123456789ABCDEF";
+
+		std::string hex;
+		for(const auto c : bytes) {
+			hex += HexDigits[ static_cast< uint8_t >( c ) >> 4 ];
+			hex += HexDigits[ static_cast< uint8_t >( c ) & 15 ];
+		}
+		return hex;
+	}
+
+	/// Cross-language vectors, Builder/Builder.test.js checks the same values for nameHash (Helpers.js)
+	static_assert( ATF::__Local__::nameHash("CPlayer", 0   ) == 1586640619u, "nameHash" );
+	static_assert( ATF::__Local__::nameHash("CPlayer", 7, 3) == 4190090293u, "nameHash" );
+	static_assert( ATF::__Local__::nameHash(""       , 0   ) == 1234692987u, "nameHash" );
+	static_assert( ATF::__Local__::nameHash("m_nHP"  , 1, 3) == 775403409u , "nameHash" );
+
+	/// Compile-time field lookup (StaticStructInfo.cpp) against the C++ layout of the generated fixture header
+	static_assert( ATF::Reflect::offsetOf("CPlayer", "m_nHP"     ) == offsetof(ATF::CPlayer, m_nHP    ), "offsetOf" );
+	static_assert( ATF::Reflect::offsetOf("CPlayer", "m_PosArr"  ) == offsetof(ATF::CPlayer, m_PosArr ), "offsetOf" );
+	static_assert( ATF::Reflect::offsetOf("CPlayer", "m_Pos.y"   ) == offsetof(ATF::CPlayer, m_Pos) + offsetof(ATF::CPos, y), "offsetOf" );
+	static_assert( ATF::Reflect::offsetOf("CParty" , "m_pMember" ) == offsetof(ATF::CParty , m_pMember), "offsetOf" );
+	static_assert( ATF::Reflect::offsetOf("CPlayer", "m_nMissing") == ATF::Reflect::StaticStructInfo::InvalidOffset, "offsetOf" );
+	static_assert( ATF::Reflect::offsetOf("CPlayer", "m_nHP.x"   ) == ATF::Reflect::StaticStructInfo::InvalidOffset, "offsetOf" );
+
+	static_assert( ATF::Reflect::fieldTypeID("CPlayer", "m_Pos"  ) == ATF::Reflect::StaticStructInfo::findNodeIDByName("CPos"), "fieldTypeID" );
+	static_assert( ATF::Reflect::StaticStructInfo::nodeType( ATF::Reflect::fieldTypeID("CPlayer", "m_pNext" ) ) == ATF::Reflect::EnumNodeType::TypePointer , "fieldTypeID" );
+	static_assert( ATF::Reflect::StaticStructInfo::nodeType( ATF::Reflect::fieldTypeID("CPlayer", "m_nLevel") ) == ATF::Reflect::EnumNodeType::TypeBitfield, "fieldTypeID" );
+	static_assert( ATF::Reflect::fieldTypeID("CPlayer", "m_nMissing") == 0, "fieldTypeID" );
+
+	#if __cplusplus >= 202002L
+		static_assert( ATF::Reflect::offsetOf< "CPlayer", "m_nHP"   >() == offsetof(ATF::CPlayer, m_nHP), "offsetOf<>" );
+		static_assert( ATF::Reflect::offsetOf< "CPlayer", "m_Pos.z" >() == offsetof(ATF::CPlayer, m_Pos) + offsetof(ATF::CPos, z), "offsetOf<>" );
+
+		static_assert( std::is_same< ATF::Reflect::fieldType< "CPlayer", "m_nHP"    >, int32_t                    >::value, "fieldType" );
+		static_assert( std::is_same< ATF::Reflect::fieldType< "CPlayer", "m_nLevel" >, uint32_t                   >::value, "fieldType" );
+		static_assert( std::is_same< ATF::Reflect::fieldType< "CPlayer", "m_pNext"  >, ATF::CPlayer*             >::value, "fieldType" );
+		static_assert( std::is_same< ATF::Reflect::fieldType< "CPlayer", "m_PosArr" >, ATF::$A< ATF::CPos, 2 >    >::value, "fieldType" );
+		static_assert( std::is_same< ATF::Reflect::fieldType< "CPlayer", "m_Value"  >, ATF::UValue                >::value, "fieldType" );
+		static_assert( std::is_same< ATF::Reflect::fieldType< "CPlayer", "m_Pos.y"  >, ATF::float32_t             >::value, "fieldType" );
+		static_assert( std::is_same< ATF::Reflect::fieldType< "CParty" , "m_pMember">, ATF::$A< ATF::CPlayer*, 0x600 > >::value, "fieldType" );
+	#endif
+
+	/// Perfect hash name/field index: every named record is found, near misses are not
+	void testStructNameHash() {
+		using namespace ATF::Reflect;
+
+		for(int32_t id = 1; id < ATF::__Local__::__StructInfoCount; id++) {
+			const auto node = getStructNodeView(id);
+			if ( !node.nameID() || ( node.type() == EnumNodeType::TypeDataMemberField ) )
+				continue;
+
+			const auto found = findStructNodeByName( node.name() );
+			check(found.valid && ( found.id == id ), "findStructNodeByName(", node.name(), ") = ", found.id, ", expected ", id);
+		}
+
+		for(const char* pName : { "", "CPlaye", "CPlayerX", "cplayer", "CPos ", "m_nHP", "x", "CPlayer::s_nCoun" })
+			check(!findStructNodeByName(pName).valid, "findStructNodeByName(\"", pName, "\") must be invalid");
+
+		eachStructNodeView([](const NodeView& node) {
+			eachStructFieldView(node, [&](const NodeView& field) {
+				const auto found = findStructFieldView(node, field.name());
+				check(found.valid() && ( found.id() == field.id() ), "findStructFieldView(", node.name(), ", ", field.name(), ")");
+			});
+		});
+
+		const auto nodePlayer = findStructNodeByName("CPlayer");
+		const auto nodePos    = findStructNodeByName("CPos");
+		check(findStructField(nodePlayer, "m_nHP").typeDataMemberField.offset == 0x20, "CPlayer::m_nHP offset");
+		check(!findStructField(nodePlayer, "x"    ).valid, "CPlayer has no field x");
+		check(!findStructField(nodePos   , "m_nHP").valid, "CPos has no field m_nHP");
+		check(!findStructField(nodePos   , "CPos" ).valid, "CPos has no field CPos");
+	}
+
+	/// Linear scan over __FuncAddrList/__FuncSizeList, the reference for the Eytzinger search
+	int32_t findFuncLinear(const uint64_t address) {
+		int32_t best = -1;
+		for(int32_t i = 0; i < ATF::__Local__::__FuncCount; i++) {
+			const uint64_t start = ATF::__Local__::__FuncAddrList[i];
+			const uint64_t size  = ATF::__Local__::__FuncSizeList[i];
+			const bool inside = size ? ( ( start <= address ) && ( address - start < size ) ) : ( address == start );
+			if ( inside && ( ( best < 0 ) || ( start > ATF::__Local__::__FuncAddrList[ best ] ) ) )
+				best = i;
+		}
+		return best;
+	}
+
+	/// Eytzinger address index: findFuncByAddress agrees with a linear scan around every function edge
+	void testFuncByAddress() {
+		using namespace ATF::Reflect;
+
+		std::vector< uint64_t > addressList = { 0, 1, ATF::Reflect::BaseAddressExpected, UINT64_MAX };
+		for(int32_t i = 0; i < ATF::__Local__::__FuncCount; i++) {
+			const uint64_t start = ATF::__Local__::__FuncAddrList[i];
+			const uint64_t end   = start + ATF::__Local__::__FuncSizeList[i];
+			for(const uint64_t address : { start - 1, start, start + 1, end - 1, end, end + 1, end + 0x1000 })
+				addressList.push_back(address);
+		}
+
+		for(const auto address : addressList) {
+			const auto info     = findFuncByAddress(address);
+			const auto expected = findFuncLinear(address);
+			check(( expected < 0 ) ? !info.valid : ( info.valid && ( info.internalID == expected ) ),
+				"findFuncByAddress(", (void*)address, ") = ", info.valid ? info.internalID : -1, ", expected ", expected);
+		}
+
+		check(findFuncByAddress(0x140011000).valid && !strcmp(findFuncByAddress(0x140011000).name, "main"), "main found by its start");
+		check(!findFuncByAddress(0x140011001).valid, "main has no size, nothing after its start");
+
+		check(findFuncByAddress(0x140010210).valid && !strcmp(findFuncByAddress(0x140010210).name, "CPlayer::AttackResume"), "size 0 symbol found by its start");
+		check(findFuncByAddress(0x140010211).valid && ( findFuncByAddress(0x140010211).address == 0x140010200 ), "size 0 symbol does not hide the function around it");
+		check(findFuncByAddress(0x14001022F).valid && ( findFuncByAddress(0x14001022F).address == 0x140010200 ), "last byte of the function around a size 0 symbol");
+	}
+
+	/// MessagePack map of nameID -> value, built by hand from the spec
+	std::string msgPackFloat32Map(const ATF::Reflect::Node& node, const std::vector< float >& valueList) {
+		using namespace ATF::Reflect;
+
+		std::string out(1, static_cast< char >( 0x80 | valueList.size() ));
+		int32_t i = 0;
+		eachStructFieldView(getStructNodeView(node), [&](const NodeView& field) {
+			out += static_cast< char >( field.nameID() );
+			out += static_cast< char >( 0xCA );
+
+			uint32_t bits = 0;
+			memcpy(&bits, &valueList[ i++ ], 4);
+			for(int32_t shift = 24; shift >= 0; shift -= 8)
+				out += static_cast< char >( ( bits >> shift ) & 0xFF );
+		});
+		return out;
+	}
+
+	/// MessagePack dump bytes, scalars keep the width of their kind (int32 -> D2, uint32 bitfield -> CE, int64 -> D3)
+	void testMsgPack() {
+		using namespace ATF;
+		using namespace ATF::Reflect;
+
+		const CPos pos = { 1.0f, -2.5f, 3.0f };
+		const auto dump = dumpStruct(&pos, TStructDumperOptions{ false, 0, "  ", true }).second;
+		check(dump == msgPackFloat32Map(findStructNodeByName("CPos"), { 1.0f, -2.5f, 3.0f }), "CPos MessagePack: ", toHex(dump));
+
+		CPlayer player = {};
+		memcpy(player.m_szName, "abc", 4);
+		player.m_nHP     = -3;
+		player.m_bLive   = true;
+		player.m_nLevel  = 21;
+		player.m_pNext   = reinterpret_cast< CPlayer* >( 0x1122334455667788 );
+		player.m_nGold   = 0x100000000;
+
+		const auto fieldID = [](const char* pName) { return static_cast< char >( findStructFieldView(getStructNodeView(findStructNodeByName("CPlayer").id), pName).nameID() ); };
+		const std::string expected = std::string("\x86", 1) +
+			fieldID("m_szName") + "\xA3" "abc" +
+			fieldID("m_nHP"   ) + "\xD2\xFF\xFF\xFF\xFD" +
+			fieldID("m_bLive" ) + "\xC3" +
+			fieldID("m_pNext" ) + std::string("\xCF\x11\x22\x33\x44\x55\x66\x77\x88", 9) +
+			fieldID("m_nLevel") + std::string("\xCE\x00\x00\x00\x15", 5) +
+			fieldID("m_nGold" ) + std::string("\xD3\x00\x00\x00\x01\x00\x00\x00\x00", 9);
+
+		const auto dumpPlayer = dumpStruct(&player, TStructDumperOptions{ false, 0, "  ", true, 0, 0, "m_szName,m_nHP,m_bLive,m_pNext,m_nLevel,m_nGold" }).second;
+		check(dumpPlayer == expected, "CPlayer MessagePack: ", toHex(dumpPlayer), ", expected ", toHex(expected));
+
+		const auto& nameTable = StructDumper::msgPackNameTable();
+		check(( nameTable.size() > 3 ) && ( static_cast< uint8_t >( nameTable[0] ) == 0xDC ), "name table is an array16");
+	}
+
+	/// diffStruct: only changed leaves, bitfields and array elements by path, every union member over changed bytes
+	void testDiff() {
+		using namespace ATF;
+		using namespace ATF::Reflect;
+
+		CPlayer playerOld = {};
+		playerOld.m_nHP = 10;
+		CPlayer playerNew = playerOld;
+		check(diffStruct(findStructNodeByName("CPlayer"), (const uint8_t*)&playerOld, (const uint8_t*)&playerNew).second == "{}", "no changes");
+
+		playerNew.m_Pos.y        = 2.0f;
+		playerNew.m_nHP          = 7;
+		playerNew.m_nLevel       = 3;
+		playerNew.m_PosArr[1].z  = -1.0f;
+		playerNew.m_Value.m_nValue = 1;
+
+		const auto diff = diffStruct(findStructNodeByName("CPlayer"), (const uint8_t*)&playerOld, (const uint8_t*)&playerNew).second;
+		check(diff ==
+			"{\n"
+			"\"m_Pos.y\": 2.000000,\n"
+			"\"m_nHP\": 7,\n"
+			"\"m_nLevel\": \"3\",\n"
+			"\"m_PosArr[1].z\": -1.000000,\n"
+			"\"m_Value.m_nValue\": \"1\",\n"
+			"\"m_Value.m_fValue\": 0.000000,\n"
+			"\"m_Value.m_byValue[0]\": 1\n"
+			"}", "diff:\n", diff);
+	}
+
+	/// Address bytecode: compiled programs against the step list they fold, on a fake address space
+	void testAddressProgram() {
+		using namespace ProcessMemoryReader::Ver_1_0_0;
+
+		std::map< uint64_t, uint64_t > memory = {
+			{ 0x1000, 0x2000 },
+			{ 0x2010, 0x3000 },
+			{ 0x3000 - 4, 0x4000 },
+		};
+		const auto fDeRef = [&](const uint64_t address, uint64_t& value) {
+			const auto it = memory.find(address);
+			if ( it == memory.end() )
+				return false;
+			value = it->second;
+			return true;
+		};
+
+		TAddressAccumulate addrAcc(0x0FF0);
+		addrAcc.relAdd(0x20);
+		addrAcc.relSub(0x10);
+		addrAcc.deRef();
+		addrAcc.relAdd(0x8);
+		addrAcc.relAdd(0x8);
+		addrAcc.deRef();
+		addrAcc.relSub(0x4);
+		addrAcc.deRef();
+		addrAcc.relAdd(0x1);
+
+		const auto program = addrAcc.compile();
+		check(( program.start == 0x1000 ) && ( program.offsetList == std::vector< uint64_t >{ 0x10, static_cast< uint64_t >( -4 ), 1 } ), "folded program");
+
+		uint64_t address = 0;
+		check(program.run(address, 0, fDeRef) && ( address == 0x4001 ), "program result ", (void*)address);
+
+		memory.erase(0x2010);
+		check(!program.run(address, 0, fDeRef), "failed deref stops the program");
+
+		TAddressAccumulate addrAccModule;
+		addrAccModule.absModule(0x20000);
+		addrAccModule.relAdd(0x28);
+		const auto programModule = addrAccModule.compile();
+		check(programModule.run(address, 0x7FF600000000, fDeRef) && ( address == 0x7FF600020028 ), "module relative start");
+
+		/// Whole expressions through the Builder, g_Player is module relative
+		const auto rec = compileExpr("g_Player.m_pNext->m_PosArr[1].y");
+		check(!rec.first.length(), "compileExpr: ", rec.first);
+		if ( rec.second ) {
+			const auto& exprProgram = rec.second->program;
+			check(exprProgram.isModuleRelative && ( exprProgram.start == 0x20028 ) && ( exprProgram.offsetList == std::vector< uint64_t >{ 0x3C + 12 + 4 } ),
+				"g_Player.m_pNext->m_PosArr[1].y program");
+
+			memory = { { 0x7FF600020028, 0x5000 } };
+			check(exprProgram.run(address, 0x7FF600000000, fDeRef) && ( address == 0x5000 + 0x3C + 12 + 4 ), "g_Player.m_pNext->m_PosArr[1].y address");
+		}
+
+		const auto recCast = compileExpr("reinterpret_cast<CPlayer*>(0x1000)->m_pNext->m_nHP");
+		check(!recCast.first.length(), "compileExpr: ", recCast.first);
+		if ( recCast.second ) {
+			const auto& exprProgram = recCast.second->program;
+			check(!exprProgram.isModuleRelative && ( exprProgram.start == 0x1028 ) && ( exprProgram.offsetList == std::vector< uint64_t >{ 0x20 } ), "cast program");
+		}
+	}
+}
+
+int main() {
+	ATF::CheckAll::checkAll();
+
+	Tests::testStructNameHash();
+	Tests::testFuncByAddress();
+	Tests::testMsgPack();
+	Tests::testDiff();
+	Tests::testAddressProgram();
+
+	std::cout << Tests::g_CheckCount - Tests::g_FailCount << "/" << Tests::g_CheckCount << " checks passed\n";
+	return Tests::g_FailCount ? 1 : 0;
+}
\ No newline at end of file